@@ -0,0 +1,76 @@
+#include "bench.h"
+#include "timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static int bench_sample_compare(const void *a, const void *b) {
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+void bench_fill(float *input, const uint32_t count, const float min, const float max) {
+	uint32_t state = 0x2545f491;
+
+	for(uint32_t i = 0; i < count; i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		input[i] = min + ((float)(state >> 8) / (float)(1 << 24)) * (max - min);
+	}
+}
+
+uint32_t bench_run(const char *title, const bench_case_t *cases, const uint32_t case_count, const float *input, const float tolerance) {
+	static float reference[BENCH_INPUT_COUNT];
+	static float output[BENCH_INPUT_COUNT];
+	static uint64_t samples[BENCH_REPETITIONS];
+	uint32_t failed = 0;
+
+	printf("%s\n", title);
+	printf("    %-24s %9s %9s %11s\n", "CASE", "BEST", "MEDIAN", "MAX ERROR");
+	cases[0].function(input, reference, BENCH_INPUT_COUNT);
+
+	for(uint32_t i = 0; i < case_count; i++) {
+		float error = 0.0f;
+
+		for(uint32_t j = 0; j < BENCH_WARMUP; j++) {
+			cases[i].function(input, output, BENCH_INPUT_COUNT);
+		}
+
+		for(uint32_t j = 0; j < BENCH_REPETITIONS; j++) {
+			const uint64_t start = timer_now_ns();
+			cases[i].function(input, output, BENCH_INPUT_COUNT);
+			samples[j] = timer_now_ns() - start;
+		}
+		qsort(samples, BENCH_REPETITIONS, sizeof(uint64_t), bench_sample_compare);
+
+		for(uint32_t j = 0; j < BENCH_INPUT_COUNT; j++) {
+			const float difference = fabsf(output[j] - reference[j]);
+			if(!(difference <= error)) {
+				error = difference;
+			}
+		}
+
+		printf("    %-24s %6.3f ns %6.3f ns %11.3g%s\n", cases[i].name,
+			(double)samples[0] / BENCH_INPUT_COUNT, (double)samples[BENCH_REPETITIONS / 2] / BENCH_INPUT_COUNT,
+			(double)error, (error <= tolerance) ? "" : "  WRONG");
+		failed += !(error <= tolerance);
+	}
+
+	return failed;
+}
+
+int main(void) {
+	uint32_t failed = 0;
+
+	failed += bench_helpers();
+
+	if(failed) {
+		printf("ERROR: %u cases didn't match their reference.\n", failed);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#define BENCH_INPUT_COUNT		4096
+#define BENCH_WARMUP			50
+#define BENCH_REPETITIONS		500
+
+/* Runs "function" over every input, one output each */
+typedef void (*bench_function_t)(const float *input, float *output, const uint32_t count);
+
+typedef struct {
+	const char *name;
+	bench_function_t function;
+} bench_case_t;
+
+/*
+ * Times every case over the same inputs, warm-up first, and prints the best and median ns per call.
+ * The first case is the reference, every other one has to land within "tolerance" of it.
+ * Returns how many cases didn't.
+ */
+uint32_t bench_run(const char *title, const bench_case_t *cases, const uint32_t case_count, const float *input, const float tolerance);
+
+/* Same inputs every run, so numbers compare between builds */
+void bench_fill(float *input, const uint32_t count, const float min, const float max);
+
+/* One per file in bench/, each returns how many of its cases failed */
+uint32_t bench_helpers(void);
+
+#endif
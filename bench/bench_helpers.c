@@ -0,0 +1,156 @@
+#include "bench.h"
+#include "helpers.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+
+#define CLAMP_MIN		0.0f
+#define CLAMP_MAX		1.0f
+
+/* What the scanline and office scroll wrap at */
+#define FMOD_MOD		752.0f
+
+/* clampf */
+static void clamp_reference(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = fminf(fmaxf(input[i], CLAMP_MIN), CLAMP_MAX);
+	}
+}
+
+static void clamp_helper(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = clampf(input[i], CLAMP_MIN, CLAMP_MAX);
+	}
+}
+
+/* What clampf used to be, minus reading the floats through a uint32_t pointer. Kept out of line like the real one */
+__attribute__((noinline)) static float clamp_sign_bits(const float x, const float min, const float max) {
+	const float difference[2] = {min - x, x - max};
+	uint32_t bits[2];
+	uint8_t above_min, below_max;
+
+	memcpy(bits, difference, sizeof(bits));
+	above_min = (uint8_t)(bits[0] >> 31);
+	below_max = (uint8_t)(bits[1] >> 31);
+	return ((above_min & below_max) * x) + ((1 - above_min) * min) + ((1 - below_max) * max);
+}
+
+static void clamp_old(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = clamp_sign_bits(input[i], CLAMP_MIN, CLAMP_MAX);
+	}
+}
+
+#ifdef __SSE2__
+static void clamp_sse_scalar(const float *input, float *output, const uint32_t count) {
+	const __m128 min = _mm_set_ss(CLAMP_MIN);
+	const __m128 max = _mm_set_ss(CLAMP_MAX);
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = _mm_cvtss_f32(_mm_min_ss(_mm_max_ss(_mm_set_ss(input[i]), min), max));
+	}
+}
+
+/* BENCH_INPUT_COUNT is a multiple of 4, so there's never a tail */
+static void clamp_sse_wide(const float *input, float *output, const uint32_t count) {
+	const __m128 min = _mm_set1_ps(CLAMP_MIN);
+	const __m128 max = _mm_set1_ps(CLAMP_MAX);
+	for(uint32_t i = 0; i < count; i += 4) {
+		_mm_storeu_ps(&output[i], _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&input[i]), min), max));
+	}
+}
+#endif
+
+/* fmod2 */
+static void fmod_reference(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = fmodf(input[i], FMOD_MOD);
+	}
+}
+
+static void fmod_helper(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = fmod2(input[i], FMOD_MOD);
+	}
+}
+
+/* What fmod2 used to be, scaling the fraction back up throws away the low bits of the remainder */
+__attribute__((noinline)) static float fmod_scaled(const float val, const float mod) {
+	const float scaled = val / mod;
+	return (scaled - (float)((int32_t)scaled)) * mod;
+}
+
+static void fmod_old(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = fmod_scaled(input[i], FMOD_MOD);
+	}
+}
+
+#ifdef __SSE2__
+static void fmod_sse_wide(const float *input, float *output, const uint32_t count) {
+	const __m128 mod = _mm_set1_ps(FMOD_MOD);
+	for(uint32_t i = 0; i < count; i += 4) {
+		const __m128 x = _mm_loadu_ps(&input[i]);
+		const __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(x, mod)));
+		_mm_storeu_ps(&output[i], _mm_sub_ps(x, _mm_mul_ps(whole, mod)));
+	}
+}
+#endif
+
+/* blink_timer_get_tick, with the title's glitchy blip numbers */
+static void blink_reference(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = fmodf(input[i] * ((10.0f / (100.0f / 60.0f)) / 2.0f), 8.0f);
+	}
+}
+
+static void blink_helper(const float *input, float *output, const uint32_t count) {
+	for(uint32_t i = 0; i < count; i++) {
+		output[i] = blink_timer_get_tick(input[i], 10.0f, 60.0f, 8.0f);
+	}
+}
+
+uint32_t bench_helpers(void) {
+	static float input[BENCH_INPUT_COUNT];
+	uint32_t failed = 0;
+
+	const bench_case_t clamp_cases[] = {
+		{"fminf/fmaxf", clamp_reference},
+		{"clampf", clamp_helper},
+		{"sign bits (old clampf)", clamp_old},
+		#ifdef __SSE2__
+			{"sse minss/maxss", clamp_sse_scalar},
+			{"sse 4 wide", clamp_sse_wide},
+		#endif
+	};
+
+	const bench_case_t fmod_cases[] = {
+		{"fmodf", fmod_reference},
+		{"fmod2", fmod_helper},
+		{"fmod2 (old)", fmod_old},
+		#ifdef __SSE2__
+			{"sse 4 wide", fmod_sse_wide},
+		#endif
+	};
+
+	const bench_case_t blink_cases[] = {
+		{"fmodf", blink_reference},
+		{"blink_timer_get_tick", blink_helper},
+	};
+
+	/* a quarter below, a quarter above, the rest inside */
+	bench_fill(input, BENCH_INPUT_COUNT, -0.5f, 1.5f);
+	failed += bench_run("clampf(x, 0, 1)", clamp_cases, sizeof(clamp_cases) / sizeof(clamp_cases[0]), input, 0.0f);
+
+	/* up to about ten minutes of "time_now * 30.0f" */
+	bench_fill(input, BENCH_INPUT_COUNT, 0.0f, 18000.0f);
+	failed += bench_run("fmod2(x, 752)", fmod_cases, sizeof(fmod_cases) / sizeof(fmod_cases[0]), input, 0.001f);
+
+	bench_fill(input, BENCH_INPUT_COUNT, 0.0f, 600.0f);
+	failed += bench_run("blink_timer_get_tick(t, 10, 60, 8)", blink_cases, sizeof(blink_cases) / sizeof(blink_cases[0]), input, 0.001f);
+
+	return failed;
+}
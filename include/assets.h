@@ -4,6 +4,7 @@
 #include "sprite.h"
 #include "sound.h"
 #include "font.h"
+#include "camera_feed.h"
 
 typedef struct {
 	sprite_t night_text_sprite;
@@ -43,7 +44,7 @@ typedef struct {
 	sprite_t hour_am_sprite;
 	sprite_t hour_number_sprite;
 
-	sprite_t camera_view_sprite;
+	camera_feed_t camera_feed;
 	sprite_t camera_view_name_sprite;
 	sprite_t camera_flip_bar_sprite;
 	sprite_t camera_flip_animation_sprite;
@@ -63,6 +64,10 @@ typedef struct {
 	sound_t camera_close_sound;
 } assets_game_t;
 
+/* Parses the manifest and checks that everything in it exists. Returns 0 if the game can't run */
+uint8_t assets_manifest_load(const char *path);
+void assets_manifest_destroy(void);
+
 assets_global_t assets_global_create(void);
 void assets_global_destroy(assets_global_t *a);
 
@@ -0,0 +1,35 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+
+/* Frames each scene gets to stream its assets in and settle before anything is recorded */
+#define BENCHMARK_WARMUP_FRAMES		60
+
+/* How many frames GPU timestamps get to come back before we wait on them */
+#define BENCHMARK_GPU_LATENCY		4
+
+enum {
+	BENCHMARK_TITLE = 0,
+	BENCHMARK_OFFICE,
+	BENCHMARK_CAMERA,
+	BENCHMARK_SCENE_COUNT
+};
+
+/* Records "frames" frames of every scene, CPU and GPU time each */
+uint8_t benchmark_create(const uint32_t frames);
+void benchmark_destroy(void);
+uint8_t benchmark_active(void);
+
+/* The scene that's being recorded, BENCHMARK_SCENE_COUNT once they're all done */
+uint8_t benchmark_scene(void);
+const char *benchmark_scene_name(const uint8_t scene);
+
+void benchmark_frame_begin(void);
+
+/* Right after the frame is presented, moves on to the next scene once this one has enough frames */
+void benchmark_frame_end(void);
+
+void benchmark_print(void);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+
+/* How many bytes of unreferenced assets get to stay loaded for the next time somebody asks */
+#ifndef CACHE_RESIDENT_BUDGET
+	#define CACHE_RESIDENT_BUDGET	(128 * 1024 * 1024)
+#endif
+
+enum {
+	CACHE_TEXTURE = 0,
+	CACHE_SOUND_BUFFER,
+};
+
+typedef void (*cache_destroy_t)(uint32_t handle);
+
+/*
+ * Reference-counted GL/AL objects keyed by the file they came from. "variant" tells apart the
+ * same file loaded with different settings (like texture filtering). Main thread only.
+ */
+
+/* Returns a new reference to the handle, or 0 if nothing's been loaded from "path" yet */
+uint32_t cache_acquire(const uint8_t kind, const char *path, const uint64_t variant);
+
+/* Hands a freshly loaded handle (with one reference) over to the cache */
+void cache_insert(const uint8_t kind, const char *path, const uint64_t variant, const uint32_t handle, const uint64_t size, cache_destroy_t destroy);
+
+/* Returns 0 if the cache has never heard of "handle", meaning the caller still owns it */
+uint8_t cache_release(const uint8_t kind, const uint32_t handle);
+
+/* Actually destroys every unreferenced entry */
+void cache_flush(void);
+void cache_destroy(void);
+
+#endif
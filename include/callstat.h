@@ -0,0 +1,83 @@
+#ifndef CALLSTAT_H
+#define CALLSTAT_H
+
+#include <stdint.h>
+
+enum {
+	CALLSTAT_DRAW = 0,
+	CALLSTAT_PROGRAM,
+	CALLSTAT_TEXTURE_BIND,
+	CALLSTAT_VAO_BIND,
+	CALLSTAT_UNIFORM,
+	CALLSTAT_BUFFER_BYTES,
+	CALLSTAT_AL,
+	CALLSTAT_COUNT
+};
+
+/* Only with -D PROFILE, include it after glad and the AL headers to count their calls */
+#ifdef PROFILE
+	extern uint64_t callstat_counters[CALLSTAT_COUNT];
+
+	#define CALLSTAT_ADD(counter, amount)	__atomic_fetch_add(&callstat_counters[counter], (uint64_t)(amount), __ATOMIC_RELAXED)
+
+	/* A NULL glBufferData only allocates, nothing gets sent */
+	static inline uint64_t callstat_buffer_bytes(const void *data, const uint64_t size) {
+		return data ? size : 0;
+	}
+
+	/* Keeps this frame's counts for "callstat_frame_get" and starts over */
+	void callstat_frame_end(void);
+	uint64_t callstat_frame_get(const uint8_t counter);
+	const char *callstat_name(const uint8_t counter);
+	void callstat_print(void);
+
+	#ifdef __glad_h_
+		#undef glDrawArrays
+		#undef glUseProgram
+		#undef glBindTexture
+		#undef glBindVertexArray
+		#undef glUniform1f
+		#undef glUniform1i
+		#undef glUniform3fv
+		#undef glUniformMatrix4fv
+		#undef glBufferData
+		#undef glBufferSubData
+		#undef glMapBufferRange
+
+		#define glDrawArrays(...)			(CALLSTAT_ADD(CALLSTAT_DRAW, 1), glad_glDrawArrays(__VA_ARGS__))
+		#define glUseProgram(...)			(CALLSTAT_ADD(CALLSTAT_PROGRAM, 1), glad_glUseProgram(__VA_ARGS__))
+		#define glBindTexture(...)			(CALLSTAT_ADD(CALLSTAT_TEXTURE_BIND, 1), glad_glBindTexture(__VA_ARGS__))
+		#define glBindVertexArray(...)		(CALLSTAT_ADD(CALLSTAT_VAO_BIND, 1), glad_glBindVertexArray(__VA_ARGS__))
+		#define glUniform1f(...)			(CALLSTAT_ADD(CALLSTAT_UNIFORM, 1), glad_glUniform1f(__VA_ARGS__))
+		#define glUniform1i(...)			(CALLSTAT_ADD(CALLSTAT_UNIFORM, 1), glad_glUniform1i(__VA_ARGS__))
+		#define glUniform3fv(...)			(CALLSTAT_ADD(CALLSTAT_UNIFORM, 1), glad_glUniform3fv(__VA_ARGS__))
+		#define glUniformMatrix4fv(...)		(CALLSTAT_ADD(CALLSTAT_UNIFORM, 1), glad_glUniformMatrix4fv(__VA_ARGS__))
+
+		#define glBufferData(target, size, data, usage)			(CALLSTAT_ADD(CALLSTAT_BUFFER_BYTES, callstat_buffer_bytes(data, size)), glad_glBufferData(target, size, data, usage))
+		#define glBufferSubData(target, offset, size, data)		(CALLSTAT_ADD(CALLSTAT_BUFFER_BYTES, size), glad_glBufferSubData(target, offset, size, data))
+		#define glMapBufferRange(target, offset, length, access)	(CALLSTAT_ADD(CALLSTAT_BUFFER_BYTES, length), glad_glMapBufferRange(target, offset, length, access))
+	#endif
+
+	/* these are real functions, a macro doesn't expand inside itself so the call underneath is the original */
+	#ifdef AL_AL_H
+		#define alSourcei(...)				(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourcei(__VA_ARGS__))
+		#define alSourcef(...)				(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourcef(__VA_ARGS__))
+		#define alSourcefv(...)				(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourcefv(__VA_ARGS__))
+		#define alSource3f(...)				(CALLSTAT_ADD(CALLSTAT_AL, 1), alSource3f(__VA_ARGS__))
+		#define alGetSourcei(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alGetSourcei(__VA_ARGS__))
+		#define alSourcePlay(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourcePlay(__VA_ARGS__))
+		#define alSourcePlayv(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourcePlayv(__VA_ARGS__))
+		#define alSourceStop(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourceStop(__VA_ARGS__))
+		#define alSourceRewind(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourceRewind(__VA_ARGS__))
+		#define alSourceQueueBuffers(...)	(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourceQueueBuffers(__VA_ARGS__))
+		#define alSourceUnqueueBuffers(...)	(CALLSTAT_ADD(CALLSTAT_AL, 1), alSourceUnqueueBuffers(__VA_ARGS__))
+		#define alBufferData(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alBufferData(__VA_ARGS__))
+		#define alGenSources(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alGenSources(__VA_ARGS__))
+		#define alDeleteSources(...)		(CALLSTAT_ADD(CALLSTAT_AL, 1), alDeleteSources(__VA_ARGS__))
+		#define alGenBuffers(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alGenBuffers(__VA_ARGS__))
+		#define alDeleteBuffers(...)		(CALLSTAT_ADD(CALLSTAT_AL, 1), alDeleteBuffers(__VA_ARGS__))
+		#define alListeneri(...)			(CALLSTAT_ADD(CALLSTAT_AL, 1), alListeneri(__VA_ARGS__))
+	#endif
+#endif
+
+#endif
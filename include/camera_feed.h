@@ -0,0 +1,56 @@
+#ifndef CAMERA_FEED_H
+#define CAMERA_FEED_H
+
+#include <stdint.h>
+#include <cglm/cglm.h>
+#include "sprite.h"
+#include "texture.h"
+#include "memstat.h"
+
+/* How many bytes of camera frames get to stay on the GPU at once */
+#ifndef CAMERA_FEED_BUDGET
+	#define CAMERA_FEED_BUDGET				(48 * 1024 * 1024)
+#endif
+
+#define CAMERA_FEED_UPLOADS_PER_FRAME		2
+
+enum {
+	CF_EMPTY = 0,
+	CF_LOADING,
+	CF_DECODED,
+	CF_RESIDENT,
+	CF_FAILED, /* didn't decode, never retried and never drawn */
+};
+
+typedef struct {
+	texture_image_t image;
+	char path[SPRITE_PATH_LENGTH_MAX];
+	uint64_t last_used;
+	uint32_t size;
+	uint8_t state;
+} camera_feed_frame_t;
+
+/* A sprite whose frames get loaded on first use and evicted least-recently-used first */
+typedef struct {
+	sprite_t sprite;
+	camera_feed_frame_t *frames;
+	uint64_t budget;
+	uint64_t resident_size;
+	uint64_t tick;
+	char owner[MEMSTAT_OWNER_LENGTH_MAX];
+	uint8_t group;
+} camera_feed_t;
+
+camera_feed_t camera_feed_create(vec2 pos, vec2 size, const char *path_format, const uint16_t frame_count, const uint64_t budget);
+
+/* Marks a frame as wanted, kicking off a background load if it isn't resident. Returns 1 if it can be drawn right now */
+uint8_t camera_feed_request(camera_feed_t *feed, const uint16_t frame);
+
+/* Uploads finished loads and evicts frames until we're back under budget. Call once per frame */
+void camera_feed_update(camera_feed_t *feed);
+
+/* Returns 0 (and draws nothing) if the frame is still loading */
+uint8_t camera_feed_draw(camera_feed_t *feed, uint32_t shader, const uint16_t frame);
+void camera_feed_destroy(camera_feed_t *feed);
+
+#endif
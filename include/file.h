@@ -3,6 +3,18 @@
 
 #include <stdint.h>
 
+typedef struct {
+	void *data;
+	uint64_t size;
+} file_mapping_t;
+
 char *file_load_contents(const char *path);
 
+/* The whole file as-is, no terminator. NULL if it can't be read */
+uint8_t *file_load_binary(const char *path, uint64_t *size);
+
+/* Read-only view of a whole file, data is NULL if it couldn't be mapped */
+file_mapping_t file_map(const char *path);
+void file_unmap(file_mapping_t *mapping);
+
 #endif
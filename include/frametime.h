@@ -0,0 +1,24 @@
+#ifndef FRAMETIME_H
+#define FRAMETIME_H
+
+#include <stdint.h>
+
+/* Log-linear, off by 1.5% at most from a microsecond up to an hour */
+#define FRAMETIME_SUB_BUCKET_BITS		7
+#define FRAMETIME_SUB_BUCKET_COUNT		(1 << FRAMETIME_SUB_BUCKET_BITS)
+#define FRAMETIME_BUCKET_COUNT			((FRAMETIME_SUB_BUCKET_COUNT / 2) * 27)
+
+/* "csv_path" can be NULL, otherwise every frame gets written there too */
+uint8_t frametime_create(const char *csv_path);
+void frametime_destroy(void);
+
+/* Once a frame, the first call only starts the clock */
+void frametime_frame(const char *state, const char *camera_state);
+
+/* How long the last frame took in nanoseconds, 0 before there's been one */
+uint64_t frametime_last(void);
+
+/* p50, p90, p99, p99.9 and the max, in milliseconds */
+void frametime_print(void);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef HEAPSTAT_H
+#define HEAPSTAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* the real declarations have to come before the macros below */
+#include <stdlib.h>
+
+#define HEAPSTAT_SITE_MAX		128
+
+/* Debug builds only, include it last. Tracks every allocation by call site so leaks get reported */
+#ifdef DEBUG
+	void *heapstat_malloc(const size_t size, const char *file, const uint32_t line);
+	void *heapstat_calloc(const size_t count, const size_t size, const char *file, const uint32_t line);
+	void *heapstat_realloc(void *data, const size_t size, const char *file, const uint32_t line);
+	void heapstat_free(void *data);
+
+	/* Once a state is done loading, every frame on this (the main) thread should allocate nothing */
+	void heapstat_steady_set(const uint8_t steady);
+
+	/* Says where the main thread allocated since the last call while steady, and how many times */
+	uint32_t heapstat_frame_check(void);
+
+	uint64_t heapstat_live_bytes(void);
+
+	/* Live bytes per call site and group, on exit that's everything that leaked */
+	void heapstat_print(const char *title);
+
+	#define malloc(size)			heapstat_malloc(size, __FILE__, __LINE__)
+	#define calloc(count, size)		heapstat_calloc(count, size, __FILE__, __LINE__)
+	#define realloc(data, size)		heapstat_realloc(data, size, __FILE__, __LINE__)
+	#define free(data)				heapstat_free(data)
+#endif
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <stdint.h>
+
+/* One column per frame, so this is also how wide every graph is in pixels */
+#define HUD_HISTORY_LENGTH			240
+#define HUD_GRAPH_HEIGHT			48
+#define HUD_GRAPH_GAP				6
+
+/* The time graphs go from 0 to two frames at 60 Hz, with a line across at one */
+#define HUD_TIME_SCALE_MS			33.333333f
+
+/* "width" is how wide the projection passed to "hud_draw" is, the graphs sit against its right edge */
+void hud_create(const float width);
+void hud_destroy(void);
+
+/* Nothing gets recorded while it's hidden, so a hidden HUD costs nothing */
+void hud_toggle(void);
+
+/* Records last frame's numbers and draws, into whatever framebuffer is bound. Does nothing while hidden */
+void hud_draw(const float *projection);
+
+#endif
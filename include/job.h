@@ -0,0 +1,20 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include <stdint.h>
+
+#define JOB_THREAD_COUNT_MAX	8
+#define JOB_QUEUE_SIZE			256
+
+typedef void (*job_function_t)(void *data);
+
+void job_system_create(const uint8_t thread_count);
+void job_system_destroy(void);
+
+/* Runs "function(data)" on a worker thread. Never touch GL or AL in there. */
+void job_submit(job_function_t function, void *data);
+
+/* Blocks until every submitted job has finished */
+void job_wait_all(void);
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <stdint.h>
+#include <cglm/cglm.h>
+#include "sprite.h"
+
+#define MANIFEST_NAME_LENGTH_MAX	64
+
+enum {
+	MANIFEST_SPRITE = 0,
+	MANIFEST_FEED,
+	MANIFEST_SOUND,
+	MANIFEST_STREAM,
+	MANIFEST_FONT,
+	MANIFEST_KIND_COUNT
+};
+
+typedef struct {
+	char name[MANIFEST_NAME_LENGTH_MAX];
+	char path[SPRITE_PATH_LENGTH_MAX];
+	vec2 position;
+	vec2 size;
+	float pitch;
+	float gain;
+	uint16_t frame_count;
+	uint8_t priority;
+	uint8_t loop;
+	uint8_t group;
+	uint8_t kind;
+} manifest_entry_t;
+
+typedef struct {
+	manifest_entry_t *entries;
+	uint32_t entry_count;
+} manifest_t;
+
+/* Returns an empty manifest (and prints why) if anything in the file doesn't parse */
+manifest_t manifest_load(const char *path);
+
+/* Makes sure every file every entry will load actually exists. Returns how many are missing */
+uint32_t manifest_validate(const manifest_t manifest);
+
+const manifest_entry_t *manifest_find(const manifest_t manifest, const uint8_t group, const char *name);
+const char *manifest_kind_name(const uint8_t kind);
+void manifest_destroy(manifest_t *manifest);
+
+#endif
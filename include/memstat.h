@@ -0,0 +1,47 @@
+#ifndef MEMSTAT_H
+#define MEMSTAT_H
+
+#include <stdint.h>
+
+#define MEMSTAT_OWNER_LENGTH_MAX	64
+
+enum {
+	MEMSTAT_GROUP_GLOBAL = 0,
+	MEMSTAT_GROUP_TITLE,
+	MEMSTAT_GROUP_GAME,
+	MEMSTAT_GROUP_COUNT
+};
+
+enum {
+	MEMSTAT_TEXTURE = 0,
+	MEMSTAT_GLYPH,
+	MEMSTAT_AUDIO,
+	MEMSTAT_KIND_COUNT
+};
+
+/*
+ * Keeps track of how many bytes every GPU texture, font glyph and audio buffer takes up,
+ * along with the asset group and the sprite/sound/font that owns it. Main thread only.
+ */
+
+/* What new records get attributed to when the caller doesn't know any better */
+void memstat_group_set(const uint8_t group);
+uint8_t memstat_group_get(void);
+void memstat_owner_set(const char *owner);
+const char *memstat_owner_get(void);
+
+void memstat_record(const uint8_t kind, const uint8_t group, const char *owner, const uint32_t handle, const uint64_t size);
+void memstat_release(const uint8_t kind, const uint32_t handle);
+
+uint64_t memstat_group_total(const uint8_t group);
+uint64_t memstat_kind_total(const uint8_t kind);
+uint64_t memstat_total(void);
+
+void memstat_print_groups(void);
+
+/* Prints the biggest owners (sprites, sounds, fonts) across every group */
+void memstat_print_top(const uint8_t count);
+
+void memstat_destroy(void);
+
+#endif
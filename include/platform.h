@@ -0,0 +1,34 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stdint.h>
+#include <cglm/cglm.h>
+
+enum {
+	PLATFORM_WINDOW = 0,
+	PLATFORM_HEADLESS
+};
+
+/* A GLFW window, or headless an EGL context where time moves 1/60th of a second per present */
+uint8_t platform_create(const uint8_t kind, const int32_t width, const int32_t height, const char *title);
+void platform_destroy(void);
+
+uint8_t platform_should_close(void);
+void platform_close(void);
+
+/* Seconds since "platform_create" */
+double platform_time(void);
+
+/* What the final image goes into, 0 for a window, an offscreen framebuffer headless */
+uint32_t platform_framebuffer(void);
+
+/* Shows the frame and picks up new input */
+void platform_present(void);
+
+/* Takes GLFW key and mouse button codes */
+uint8_t platform_key_down(const int32_t key);
+uint8_t platform_mouse_down(const int32_t button);
+void platform_mouse_position(ivec2 output);
+void platform_mouse_set(const int32_t x, const int32_t y);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+#define PROFILE_HISTORY_LENGTH		240
+
+/* How many frames GPU timings get to come back before we ask, so reading them never stalls */
+#define PROFILE_GPU_LATENCY			4
+
+enum {
+	PROFILE_FRAME = 0,
+	PROFILE_INPUT,
+	PROFILE_UPDATE,
+	PROFILE_TITLE_DRAW,
+	PROFILE_GAME_DRAW,
+	PROFILE_POST,
+	PROFILE_UI,
+	PROFILE_SWAP,
+	PROFILE_SCOPE_COUNT
+};
+
+typedef struct {
+	double min;
+	double avg;
+	double max;
+	double p99;
+	uint16_t sample_count;
+} profile_stats_t;
+
+/* Only with -D PROFILE, everywhere else the macros are empty */
+#ifdef PROFILE
+	#define PROFILE_CREATE()			profile_create()
+	#define PROFILE_DESTROY()			profile_destroy()
+	#define PROFILE_BEGIN(scope)		profile_begin(scope)
+	#define PROFILE_END(scope)			profile_end(scope)
+	#define PROFILE_GPU_BEGIN(scope)	profile_gpu_begin(scope)
+	#define PROFILE_GPU_END(scope)		profile_gpu_end(scope)
+	#define PROFILE_FRAME_END()			profile_frame_end()
+
+	/* Needs a GL context for the queries */
+	void profile_create(void);
+	void profile_destroy(void);
+
+	void profile_begin(const uint8_t scope);
+	void profile_end(const uint8_t scope);
+
+	/* These can't nest, GL only lets one GL_TIME_ELAPSED query run at a time */
+	void profile_gpu_begin(const uint8_t scope);
+	void profile_gpu_end(const uint8_t scope);
+
+	/* Commits this frame's totals and picks up GPU timings from PROFILE_GPU_LATENCY frames ago */
+	void profile_frame_end(void);
+
+	/* In milliseconds, the GPU ones lag a few frames behind */
+	profile_stats_t profile_stats(const uint8_t scope);
+	profile_stats_t profile_gpu_stats(const uint8_t scope);
+
+	/* Just the last frame in nanoseconds, 0 when the scope didn't run or its GPU time didn't come back */
+	uint64_t profile_last(const uint8_t scope);
+	uint64_t profile_gpu_last(const uint8_t scope);
+	const char *profile_scope_name(const uint8_t scope);
+	void profile_print(void);
+#else
+	#define PROFILE_CREATE()
+	#define PROFILE_DESTROY()
+	#define PROFILE_BEGIN(scope)
+	#define PROFILE_END(scope)
+	#define PROFILE_GPU_BEGIN(scope)
+	#define PROFILE_GPU_END(scope)
+	#define PROFILE_FRAME_END()
+#endif
+
+#endif
@@ -2,23 +2,86 @@
 #define SOUND_H
 
 #include <stdint.h>
+#include "file.h"
+
+#define SOUND_COMMAND_SLOT_MAX		64
+#define SOUND_STATIC_BUFFER_MAX		64
+
+/* Where decoded PCM gets cached so later starts don't have to go through libsndfile */
+#ifndef SOUND_PCM_CACHE_DIRECTORY
+	#define SOUND_PCM_CACHE_DIRECTORY	"cache/"
+#endif
 
 typedef uint32_t sound_buffer_t;
 typedef uint32_t sound_source_t;
+typedef struct sound_stream sound_stream_t;
 typedef struct {
+	const char *path; /* not owned, only kept around for reporting */
 	sound_buffer_t buffer;
-	sound_source_t source;
+	sound_source_t source; /* 0 for one-shots, which borrow a voice from the pool */
+	sound_stream_t *stream;
+	float position[3];
+	float pitch;
+	float gain;
+	uint32_t id;
+	uint8_t priority;
 } sound_t;
 
-void sound_system_create(void);
+/* Decoded samples that haven't been handed to AL yet, either malloced or pointing into a mapped cache file */
+typedef struct {
+	file_mapping_t mapping;
+	int16_t *samples;
+	uint64_t size;
+	int32_t format;
+	int32_t sample_rate;
+} sound_pcm_t;
+
+/* Context attributes, anything left at 0 is up to the implementation */
+typedef struct {
+	int32_t frequency;
+	int32_t refresh;
+	int32_t mono_sources;
+	int32_t stereo_sources;
+	int32_t loopback_frequency; /* renders into memory at this rate instead of opening a sound card (see sound_loopback.h) */
+} sound_config_t;
+
+/* Only fails if a loopback device was asked for and there isn't one */
+uint8_t sound_system_create(const sound_config_t config);
 void sound_system_destroy(void);
 
+/*
+ * Doesn't touch AL, so it's safe to call from a job. Comes out at the device's mixing rate.
+ * PCM16 WAVs that are already at that rate get mapped as-is, everything else comes from the PCM cache
+ * if it's there and still matches the file, and only then from libsndfile.
+ */
+sound_pcm_t sound_pcm_load(const char *path);
+void sound_pcm_free(sound_pcm_t *pcm);
+
+/* Buffers are shared between everyone who loads the same path */
+sound_buffer_t sound_buffer_find(const char *path);
+
+/* Might take the mapping out of "pcm" if AL can read it in place, free it either way */
+sound_buffer_t sound_buffer_create_shared(const char *path, sound_pcm_t *pcm);
 sound_buffer_t sound_buffer_create(const char *path);
+void sound_buffer_destroy(sound_buffer_t *sound_buffer);
 sound_source_t sound_source_create(sound_buffer_t sound_buffer, const float pitch, const float gain, const float *position, const uint8_t loop);
-sound_t sound_create(const char *path, const float pitch, const float gain, const float *position, const uint8_t loop);
+
+/* Looping sounds get a source of their own, everything else plays on pooled voices so it can overlap itself */
+sound_t sound_create(const char *path, const float pitch, const float gain, const float *position, const uint8_t loop, const uint8_t priority);
+
+/* Same as "sound_create", but decodes as it plays instead of all up front. Meant for long sounds */
+sound_t sound_stream_create(const char *path, const float pitch, const float gain, const float *position, const uint8_t loop);
+
+/*
+ * These only get queued, nothing reaches AL until "sound_flush". The last write for a sound wins,
+ * a stop followed by a play is just a play and a gain that didn't change is dropped.
+ */
 void sound_set_gain(const sound_t sound, const float gain);
 void sound_play(const sound_t sound);
 void sound_stop(const sound_t sound);
+
+/* Once a frame, hands everything to the audio thread with the same timestamp so it lands in the same mix */
+void sound_flush(void);
 void sound_destroy(sound_t *sound);
 
 #endif
@@ -0,0 +1,24 @@
+#ifndef SOUND_LATENCY_H
+#define SOUND_LATENCY_H
+
+#include <stdint.h>
+#include "sound.h"
+
+#define SOUND_LATENCY_PENDING_MAX		32
+#define SOUND_LATENCY_SOUND_MAX			64
+
+/* Anything slower than this didn't make it out within a frame */
+#define SOUND_LATENCY_FRAME_NS			16666667
+
+/*
+ * Measures how long it takes from "sound_play" (not the flush) until the source says AL_PLAYING,
+ * and until its sample offset actually starts moving (the mixer picked it up).
+ * Polled from the audio thread, so the resolution is SOUND_THREAD_SLEEP_NS.
+ */
+void sound_latency_trigger(const sound_t sound, const sound_source_t source, const uint64_t requested);
+void sound_latency_poll(void);
+
+/* Per sound min/avg/max, and how many triggers took longer than a frame */
+void sound_latency_print(void);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SOUND_LOOPBACK_H
+#define SOUND_LOOPBACK_H
+
+#include <stdint.h>
+#include <AL/alc.h>
+
+#define SOUND_LOOPBACK_CHANNELS			2
+#define SOUND_LOOPBACK_BLOCK_FRAMES		1024
+#define SOUND_LOOPBACK_LOG_MAX			1024
+
+/*
+ * Headless audio through ALC_SOFT_loopback. Nothing goes to a sound card, the mixer renders
+ * 16-bit stereo into a scratch block whenever "sound_loopback_render" asks it to, and only the peak is kept.
+ * Every play gets logged against how far the render has got.
+ */
+ALCdevice *sound_loopback_open(const int32_t frequency);
+
+/* Adds the render format the context has to be created with, returns the new attribute count */
+uint8_t sound_loopback_attributes(int32_t *attributes, uint8_t attribute_count);
+uint8_t sound_loopback_active(void);
+
+/* Mixes however many frames "seconds" is worth */
+void sound_loopback_render(const double seconds);
+void sound_loopback_log(const char *path);
+
+/* What played when, and how long the mixer took to render it all */
+void sound_loopback_print(void);
+void sound_loopback_close(void);
+
+#endif
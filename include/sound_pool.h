@@ -0,0 +1,29 @@
+#ifndef SOUND_POOL_H
+#define SOUND_POOL_H
+
+#include <stdint.h>
+#include "sound.h"
+
+#define SOUND_POOL_VOICE_COUNT		16
+
+/*
+ * One-shot sounds don't own a source, they borrow one of these voices every time they play.
+ * When they're all busy, the lowest priority voice gets stolen (the quietest, then the oldest, breaks ties).
+ */
+void sound_pool_create(void);
+void sound_pool_destroy(void);
+
+/*
+ * Sets a voice up for the sound without starting it, so several can start together. 0 if it got dropped.
+ * "gain" is the sound's current gain, "sound" is only a copy and still has the one it was created with
+ */
+sound_source_t sound_pool_acquire(const sound_t sound, const float gain);
+
+/* These hit every voice the sound is currently playing on */
+void sound_pool_stop(const sound_t sound);
+void sound_pool_set_gain(const sound_t sound, const float gain);
+
+/* Stops the sound everywhere and lets go of its buffer, so it can be deleted */
+void sound_pool_release(const sound_t sound);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef SOUND_STREAM_H
+#define SOUND_STREAM_H
+
+#include <stdint.h>
+#include "sound.h"
+
+#define SOUND_STREAM_BUFFER_COUNT		4
+#define SOUND_STREAM_CHUNK_FRAMES		8192
+#define SOUND_STREAM_COUNT_MAX			16
+
+/*
+ * Long sounds (music, looping ambience) get decoded a chunk at a time on the audio thread
+ * and fed to their source through a small ring of queued buffers. Compressed files (Ogg Vorbis,
+ * Opus, FLAC) are read into memory whole and decoded from there, plain PCM is read off the disk.
+ */
+/* NULL when SOUND_STREAM_COUNT_MAX are already open */
+sound_stream_t *sound_stream_open(const char *path, const sound_source_t source, const uint8_t loop);
+
+/* Refills whatever the playing streams have used up, called by the audio thread every tick */
+void sound_stream_service_all(void);
+
+/* Rewinds and queues up the first few chunks, the source still needs starting */
+sound_source_t sound_stream_prepare(sound_stream_t *stream);
+void sound_stream_stop(sound_stream_t *stream);
+void sound_stream_close(sound_stream_t *stream);
+
+#endif
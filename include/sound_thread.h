@@ -0,0 +1,37 @@
+#ifndef SOUND_THREAD_H
+#define SOUND_THREAD_H
+
+#include <stdint.h>
+#include "sound.h"
+
+#define SOUND_THREAD_QUEUE_SIZE			256 /* has to be a power of two */
+#define SOUND_THREAD_PENDING_MAX		128
+#define SOUND_THREAD_SLEEP_NS			5000000
+
+enum {
+	SOUND_THREAD_PLAY = 0,
+	SOUND_THREAD_STOP,
+	SOUND_THREAD_GAIN,
+	SOUND_THREAD_RELEASE
+};
+
+/* "time" is when it should happen, "requested" is when the game asked for it (for latency), "gain" is for gain changes and plays */
+typedef struct {
+	sound_t sound;
+	uint64_t time;
+	uint64_t requested;
+	float gain;
+	uint8_t type;
+} sound_thread_command_t;
+
+/* Commands due at the same time start with one alSourcePlayv, so they stay sample-aligned */
+void sound_thread_create(void);
+void sound_thread_destroy(void);
+
+/* Main thread only */
+void sound_thread_push(const sound_thread_command_t command);
+
+/* Wakes the thread and blocks until everything pushed so far has run, so sources and buffers can be deleted safely */
+void sound_thread_wait(void);
+
+#endif
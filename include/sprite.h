@@ -5,6 +5,8 @@
 #include <cglm/cglm.h>
 #include "texture.h"
 
+#define SPRITE_PATH_LENGTH_MAX 256
+
 typedef struct {
 	uint32_t vao;
 	uint32_t vbo;
@@ -19,6 +21,13 @@ typedef struct {
 } sprite_t;
 
 sprite_t sprite_create(vec2 pos, vec2 size, const char *path_format, const uint16_t texture_count);
+
+/* Same as "sprite_create", but every texture is left as 0 for the caller to fill in */
+sprite_t sprite_create_empty(vec2 pos, vec2 size, const uint16_t texture_count);
+
+/* Single textures use "path_format" as-is, animations get "<path_format><index>.png" */
+void sprite_texture_path(const char *path_format, const uint16_t texture_count, const uint16_t texture_index, char *output);
+
 void sprite_draw(sprite_t sprite, uint32_t shader, const uint16_t texture_index);
 void sprite_destroy(sprite_t *sprite);
 
@@ -0,0 +1,23 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdint.h>
+
+#define STARTUP_PHASE_MAX			24
+#define STARTUP_ASSET_MAX			512
+#define STARTUP_SLOWEST_COUNT		10
+#define STARTUP_PATH_LENGTH_MAX		128
+
+/* Times from launch to the first frame, phase by phase */
+void startup_begin(void);
+
+/* Closes the phase that's been running since "startup_begin" or the last call */
+void startup_phase(const char *name);
+
+/* Fonts, streams and feeds load inside their create call, all of that counts as decode */
+void startup_asset(const char *path, const char *kind, const uint64_t decode_ns, const uint64_t upload_ns);
+
+/* Prints the table, and writes it as JSON too when "json_path" isn't NULL. Only the first call does anything */
+void startup_finish(const char *json_path);
+
+#endif
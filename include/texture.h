@@ -4,6 +4,31 @@
 #include <stdint.h>
 
 typedef uint32_t texture_t;
+
+/* Decoded pixels waiting to be uploaded. Loading these is safe off the GL thread. */
+typedef struct {
+	uint8_t *pixels;
+	int32_t width;
+	int32_t height;
+	int32_t channels;
+} texture_image_t;
+
+texture_image_t texture_image_load(const char *path);
+void texture_image_free(texture_image_t *image);
+
+/* Roughly what the image costs once it's on the GPU */
+uint64_t texture_image_size(const texture_image_t image);
+
+texture_t texture_create_from_image(const texture_image_t image, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation);
+
+/* Returns a new reference to "path" if it's already loaded with these settings, otherwise 0 */
+texture_t texture_find(const char *path, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation);
+
+/* Uploads an image that was decoded from "path" and shares it like "texture_create" would */
+texture_t texture_create_shared(const char *path, const texture_image_t image, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation);
+
+/* Shares the texture with anyone else who loaded "path" with the same settings */
 texture_t texture_create(const char *path, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation);
+void texture_destroy(texture_t *texture);
 
 #endif
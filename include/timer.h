@@ -0,0 +1,12 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+/* Monotonic clock in nanoseconds, for measuring how long things take. Safe from any thread */
+uint64_t timer_now_ns(void);
+
+/* Nanoseconds to milliseconds, for printing */
+double timer_ms(const uint64_t ns);
+
+#endif
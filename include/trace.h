@@ -0,0 +1,27 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/* Chrome trace-event JSON, everything is a no-op until "trace_create". Safe from any thread */
+uint8_t trace_create(const char *path);
+void trace_destroy(void);
+uint8_t trace_active(void);
+
+/* Labels the calling thread's track */
+void trace_thread_name(const char *name);
+
+/* A span on the calling thread, begin and end have to nest */
+void trace_begin(const char *name, const char *category);
+void trace_end(const char *name, const char *category);
+
+/* A span that already happened, from two timer_now_ns() values */
+void trace_complete(const char *name, const char *category, const uint64_t start, const uint64_t end);
+
+/* A marker across every track, for things like state changes */
+void trace_instant(const char *name, const char *category);
+
+/* Spans the time since the last call, once per frame */
+void trace_frame(void);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef UPLOAD_H
+#define UPLOAD_H
+
+#include <stdint.h>
+#include "texture.h"
+
+#define UPLOAD_RING_SIZE		3
+
+/*
+ * Streams texture data through a ring of pixel-unpack buffers. The copy into the buffer is the only
+ * work left on the calling thread, the driver does the conversion and transfer whenever it gets to it,
+ * and a fence keeps us from scribbling over a buffer that's still being read from.
+ */
+void upload_system_create(void);
+void upload_system_destroy(void);
+
+/* Fills the currently bound GL_TEXTURE_2D. Falls back to a plain glTexImage2D without the upload system */
+void upload_texture_image(const texture_image_t image, const int32_t internal_format, const uint32_t format);
+
+#endif
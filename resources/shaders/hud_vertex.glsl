@@ -0,0 +1,13 @@
+#version 330 core
+
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec4 a_color;
+
+uniform mat4 projection;
+
+out vec4 color;
+
+void main() {
+	gl_Position = projection * vec4(a_position, 0.0f, 1.0f);
+	color = a_color;
+}
@@ -2,29 +2,411 @@
 #include "font.h"
 #include "sound.h"
 #include "sprite.h"
+#include "camera_feed.h"
+#include "memstat.h"
+#include "manifest.h"
+#include "job.h"
+#include "timer.h"
+#include "trace.h"
+#include "startup.h"
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
 #include <cglm/vec2.h>
 
+#include "heapstat.h"
+
+#define ASSETS_BINDING(type, field, kind) {#field, offsetof(type, field), kind}
+
+/* Which field every manifest entry gets loaded into, in load order */
+typedef struct {
+	const char *name;
+	size_t offset;
+	uint8_t kind;
+} assets_binding_t;
+
+/* A texture or sound buffer that gets decoded on a worker before the group is created */
+typedef struct {
+	char path[SPRITE_PATH_LENGTH_MAX];
+	const char *owner;
+	texture_image_t image;
+	texture_t texture;
+	sound_pcm_t pcm;
+	sound_buffer_t buffer;
+	uint64_t decode_start;
+	uint64_t decode_end;
+	uint8_t kind;
+} assets_prefetch_t;
+
+/* How long one kind of prefetch took, to see whether images and audio actually decode side by side */
+typedef struct {
+	uint64_t decode_start;
+	uint64_t decode_end;
+	uint64_t decode_busy;
+	uint64_t upload;
+	uint32_t count;
+} assets_timing_t;
+
+static const assets_binding_t global_bindings[] = {
+	ASSETS_BINDING(assets_global_t, night_text_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_global_t, night_number_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_global_t, static_animation_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_global_t, blip_animation_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_global_t, black_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_global_t, blip_sound, MANIFEST_SOUND),
+	ASSETS_BINDING(assets_global_t, static_sound, MANIFEST_SOUND),
+	ASSETS_BINDING(assets_global_t, debug_font, MANIFEST_FONT),
+};
+
+static const assets_binding_t title_bindings[] = {
+	ASSETS_BINDING(assets_title_t, name_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_title_t, scanline_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_title_t, glitchy_blip, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_title_t, freddy_face_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_title_t, copyright_sprites, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_title_t, menu_option_sprites, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_title_t, music, MANIFEST_STREAM),
+};
+
+static const assets_binding_t game_bindings[] = {
+	ASSETS_BINDING(assets_game_t, door_animation_sprites[0], MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, door_animation_sprites[1], MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, office_view_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_feed, MANIFEST_FEED),
+	ASSETS_BINDING(assets_game_t, camera_view_name_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, fan_animation_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, door_button_sprites[0], MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, door_button_sprites[1], MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, power_usage_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, power_usage_text_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, power_left_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, power_left_percent_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, power_left_number_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, hour_am_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, hour_number_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_flip_bar_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_flip_animation_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_border_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_map_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_recording_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_button_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_button_name_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, camera_disabled_sprite, MANIFEST_SPRITE),
+	ASSETS_BINDING(assets_game_t, fan_sound, MANIFEST_STREAM),
+	ASSETS_BINDING(assets_game_t, light_sound, MANIFEST_STREAM),
+	ASSETS_BINDING(assets_game_t, door_sound, MANIFEST_SOUND),
+	ASSETS_BINDING(assets_game_t, freddy_nose_sound, MANIFEST_SOUND),
+	ASSETS_BINDING(assets_game_t, camera_open_sound, MANIFEST_SOUND),
+	ASSETS_BINDING(assets_game_t, camera_scan_sound, MANIFEST_SOUND),
+	ASSETS_BINDING(assets_game_t, camera_close_sound, MANIFEST_SOUND),
+};
+
+static const assets_binding_t *group_bindings[MEMSTAT_GROUP_COUNT] = {global_bindings, title_bindings, game_bindings};
+static const uint8_t group_binding_counts[MEMSTAT_GROUP_COUNT] = {
+	sizeof(global_bindings) / sizeof(assets_binding_t),
+	sizeof(title_bindings) / sizeof(assets_binding_t),
+	sizeof(game_bindings) / sizeof(assets_binding_t),
+};
+
+static manifest_t manifest = {NULL, 0};
+
 static uint8_t global_loaded = 0;
 static uint8_t title_loaded = 0;
 static uint8_t game_loaded = 0;
 
-assets_global_t assets_global_create() {
+uint8_t assets_manifest_load(const char *path) {
+	uint32_t problems = 0;
+
+	manifest = manifest_load(path);
+	if(!manifest.entry_count)
+		return 0;
+
+	/* every field needs exactly one entry of the right kind, and every entry needs a field */
+	for(uint8_t group = 0; group < MEMSTAT_GROUP_COUNT; group++) {
+		uint32_t group_entry_count = 0;
+		for(uint32_t i = 0; i < manifest.entry_count; i++) {
+			group_entry_count += manifest.entries[i].group == group;
+		}
+
+		for(uint8_t i = 0; i < group_binding_counts[group]; i++) {
+			const assets_binding_t *binding = &group_bindings[group][i];
+			const manifest_entry_t *entry = manifest_find(manifest, group, binding->name);
+			if(!entry || entry->kind != binding->kind) {
+				printf("ERROR: Manifest entry for '%s' is missing or the wrong kind.\n", binding->name);
+				problems++;
+			}
+		}
+
+		if(group_entry_count != group_binding_counts[group]) {
+			printf("ERROR: Manifest has %u entries for a group with %u assets.\n", group_entry_count, group_binding_counts[group]);
+			problems++;
+		}
+	}
+
+	problems += manifest_validate(manifest);
+	if(problems) {
+		manifest_destroy(&manifest);
+		return 0;
+	}
+
+	return 1;
+}
+
+void assets_manifest_destroy(void) {
+	manifest_destroy(&manifest);
+}
+
+static void assets_prefetch_job(void *data) {
+	assets_prefetch_t *prefetch = data;
+
+	prefetch->decode_start = timer_now_ns();
+	if(prefetch->kind == MANIFEST_SOUND) {
+		prefetch->pcm = sound_pcm_load(prefetch->path);
+	} else {
+		prefetch->image = texture_image_load(prefetch->path);
+	}
+	prefetch->decode_end = timer_now_ns();
+	trace_complete(prefetch->path, (prefetch->kind == MANIFEST_SOUND) ? "sound decode" : "texture decode", prefetch->decode_start, prefetch->decode_end);
+}
+
+/* both doors are the same frames, a file only needs decoding and uploading once however many bindings use it */
+static uint8_t assets_prefetch_queued(const assets_prefetch_t *prefetches, const uint32_t count, const char *path) {
+	for(uint32_t i = 0; i < count; i++) {
+		if(!strcmp(prefetches[i].path, path))
+			return 1;
+	}
+
+	return 0;
+}
+
+static void assets_timing_add(assets_timing_t *timing, const assets_prefetch_t *prefetch, const uint64_t upload) {
+	if(!timing->count || prefetch->decode_start < timing->decode_start) {
+		timing->decode_start = prefetch->decode_start;
+	}
+
+	if(prefetch->decode_end > timing->decode_end) {
+		timing->decode_end = prefetch->decode_end;
+	}
+
+	timing->decode_busy += prefetch->decode_end - prefetch->decode_start;
+	timing->upload += upload;
+	timing->count++;
+}
+
+static const char *group_names[MEMSTAT_GROUP_COUNT] = {"GLOBAL", "TITLE", "GAME"};
+
+#ifdef DEBUG
+
+static void assets_timing_print(const char *name, const assets_timing_t timing, const uint64_t start) {
+	if(!timing.count) {
+		printf("    %-6s nothing to decode\n", name);
+		return;
+	}
+
+	printf("    %-6s %3u decoded from +%7.2f ms to +%7.2f ms (%8.2f ms of work), %7.2f ms to hand off\n", name, timing.count,
+		timer_ms(timing.decode_start - start), timer_ms(timing.decode_end - start),
+		timer_ms(timing.decode_busy), timer_ms(timing.upload));
+}
+
+static void assets_load_print(const uint8_t group, const assets_timing_t images, const assets_timing_t sounds, const uint64_t start, const uint64_t end) {
+	uint64_t overlap_start, overlap_end, overlap = 0;
+
+	if(images.count && sounds.count) {
+		overlap_start = images.decode_start > sounds.decode_start ? images.decode_start : sounds.decode_start;
+		overlap_end = images.decode_end < sounds.decode_end ? images.decode_end : sounds.decode_end;
+		overlap = overlap_end > overlap_start ? overlap_end - overlap_start : 0;
+	}
+
+	printf("LOADED %s in %.2f ms\n", group_names[group], timer_ms(end - start));
+	assets_timing_print("images", images, start);
+	assets_timing_print("audio", sounds, start);
+	printf("    %-6s %.2f ms of image and audio decoding overlapped\n", "", timer_ms(overlap));
+}
+#endif
+
+static void assets_group_create(const uint8_t group, uint8_t *assets) {
+	const assets_binding_t *bindings = group_bindings[group];
+	const uint8_t binding_count = group_binding_counts[group];
+	assets_prefetch_t *prefetches;
+	uint32_t prefetch_count = 0;
+	assets_timing_t image_timing = {0, 0, 0, 0, 0};
+	assets_timing_t sound_timing = {0, 0, 0, 0, 0};
+	const uint64_t load_start = timer_now_ns();
+
+	memstat_group_set(group);
+
+	/* decode every texture and sound buffer the group needs in parallel up front */
+	for(uint8_t i = 0; i < binding_count; i++) {
+		if(bindings[i].kind == MANIFEST_SPRITE || bindings[i].kind == MANIFEST_SOUND) {
+			prefetch_count += manifest_find(manifest, group, bindings[i].name)->frame_count;
+		}
+	}
+
+	prefetches = calloc(prefetch_count, sizeof(assets_prefetch_t));
+	prefetch_count = 0;
+
+	/* sounds go in first, they're the fewest but take the longest each */
+	for(uint8_t i = 0; i < binding_count; i++) {
+		const manifest_entry_t *entry = manifest_find(manifest, group, bindings[i].name);
+		assets_prefetch_t *prefetch;
+		if(bindings[i].kind != MANIFEST_SOUND)
+			continue;
+
+		if(assets_prefetch_queued(prefetches, prefetch_count, entry->path))
+			continue;
+
+		prefetch = &prefetches[prefetch_count++];
+		snprintf(prefetch->path, SPRITE_PATH_LENGTH_MAX, "%s", entry->path);
+		prefetch->owner = entry->path;
+		prefetch->kind = MANIFEST_SOUND;
+		prefetch->buffer = sound_buffer_find(prefetch->path);
+		if(!prefetch->buffer) {
+			job_submit(assets_prefetch_job, prefetch);
+		}
+	}
+
+	for(uint8_t i = 0; i < binding_count; i++) {
+		const manifest_entry_t *entry = manifest_find(manifest, group, bindings[i].name);
+		if(bindings[i].kind != MANIFEST_SPRITE)
+			continue;
+
+		for(uint16_t j = 0; j < entry->frame_count; j++) {
+			assets_prefetch_t *prefetch = &prefetches[prefetch_count];
+			sprite_texture_path(entry->path, entry->frame_count, j, prefetch->path);
+			if(assets_prefetch_queued(prefetches, prefetch_count, prefetch->path))
+				continue;
+
+			prefetch_count++;
+			prefetch->owner = entry->path;
+			prefetch->kind = MANIFEST_SPRITE;
+			prefetch->texture = texture_find(prefetch->path, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+			if(!prefetch->texture) {
+				job_submit(assets_prefetch_job, prefetch);
+			}
+		}
+	}
+
+	/* GL and AL both want their data handed over on this thread */
+	job_wait_all();
+	for(uint32_t i = 0; i < prefetch_count; i++) {
+		assets_prefetch_t *prefetch = &prefetches[i];
+		const uint64_t upload_start = timer_now_ns();
+		uint64_t upload_end;
+
+		if(prefetch->kind == MANIFEST_SOUND) {
+			if(prefetch->buffer || !prefetch->pcm.samples)
+				continue;
+
+			prefetch->buffer = sound_buffer_create_shared(prefetch->path, &prefetch->pcm);
+			sound_pcm_free(&prefetch->pcm);
+			upload_end = timer_now_ns();
+			trace_complete(prefetch->path, "sound upload", upload_start, upload_end);
+			startup_asset(prefetch->path, manifest_kind_name(MANIFEST_SOUND), prefetch->decode_end - prefetch->decode_start, upload_end - upload_start);
+			assets_timing_add(&sound_timing, prefetch, upload_end - upload_start);
+			continue;
+		}
+
+		if(prefetch->texture || !prefetch->image.pixels)
+			continue;
+
+		memstat_owner_set(prefetch->owner);
+		prefetch->texture = texture_create_shared(prefetch->path, prefetch->image, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+		texture_image_free(&prefetch->image);
+		upload_end = timer_now_ns();
+		trace_complete(prefetch->path, "texture upload", upload_start, upload_end);
+		startup_asset(prefetch->path, manifest_kind_name(MANIFEST_SPRITE), prefetch->decode_end - prefetch->decode_start, upload_end - upload_start);
+		assets_timing_add(&image_timing, prefetch, upload_end - upload_start);
+	}
+
+	/* everything below finds its textures and sound buffers in the cache */
+	for(uint8_t i = 0; i < binding_count; i++) {
+		const manifest_entry_t *entry = manifest_find(manifest, group, bindings[i].name);
+		void *field = assets + bindings[i].offset;
+		const uint64_t create_start = timer_now_ns();
+		vec2 position, size;
+
+		glm_vec2_copy((float *)entry->position, position);
+		glm_vec2_copy((float *)entry->size, size);
+		trace_begin(bindings[i].name, "asset create");
+		switch(entry->kind) {
+			case MANIFEST_SPRITE:
+				*(sprite_t *)field = sprite_create(position, size, entry->path, entry->frame_count);
+				break;
+
+			case MANIFEST_FEED:
+				*(camera_feed_t *)field = camera_feed_create(position, size, entry->path, entry->frame_count, CAMERA_FEED_BUDGET);
+				break;
+
+			case MANIFEST_SOUND:
+				*(sound_t *)field = sound_create(entry->path, entry->pitch, entry->gain, GLM_VEC3_ZERO, entry->loop, entry->priority);
+				break;
+
+			case MANIFEST_STREAM:
+				*(sound_t *)field = sound_stream_create(entry->path, entry->pitch, entry->gain, GLM_VEC3_ZERO, entry->loop);
+				break;
+
+			case MANIFEST_FONT:
+				*(font_t *)field = font_create(entry->path);
+				break;
+		}
+		trace_end(bindings[i].name, "asset create");
+
+		/* sprites and sounds were prefetched above, the rest load right here */
+		if(entry->kind == MANIFEST_FEED || entry->kind == MANIFEST_STREAM || entry->kind == MANIFEST_FONT) {
+			startup_asset(entry->path, manifest_kind_name(entry->kind), timer_now_ns() - create_start, 0);
+		}
+	}
+
+	/* the sprites and sounds hold their own references now */
+	for(uint32_t i = 0; i < prefetch_count; i++) {
+		texture_destroy(&prefetches[i].texture);
+		sound_buffer_destroy(&prefetches[i].buffer);
+	}
+	free(prefetches);
+	trace_complete(group_names[group], "group load", load_start, timer_now_ns());
+
+	#ifdef DEBUG
+		assets_load_print(group, image_timing, sound_timing, load_start, timer_now_ns());
+	#endif
+}
+
+static void assets_group_destroy(const uint8_t group, uint8_t *assets) {
+	const assets_binding_t *bindings = group_bindings[group];
+
+	trace_begin(group_names[group], "group unload");
+	for(uint8_t i = group_binding_counts[group]; i-- > 0;) {
+		void *field = assets + bindings[i].offset;
+		switch(bindings[i].kind) {
+			case MANIFEST_SPRITE:
+				sprite_destroy((sprite_t *)field);
+				break;
+
+			case MANIFEST_FEED:
+				camera_feed_destroy((camera_feed_t *)field);
+				break;
+
+			case MANIFEST_SOUND:
+			case MANIFEST_STREAM:
+				sound_destroy((sound_t *)field);
+				break;
+
+			case MANIFEST_FONT:
+				font_destroy((font_t *)field);
+				break;
+		}
+	}
+	trace_end(group_names[group], "group unload");
+}
+
+assets_global_t assets_global_create(void) {
 	assets_global_t a;
 	assert(!global_loaded);
 
 	font_shader_create();
-	a.night_text_sprite = sprite_create((vec2){1148, 74}, (vec2){63, 14}, "resources/graphics/ui/night/night.png", 1);
-	a.night_number_sprite = sprite_create((vec2){1223, 72}, (vec2){14, 17}, "resources/graphics/ui/night/", 7);
-	a.static_animation_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1280.0f, 720.0f}, "resources/graphics/general/static/", 8);
-	a.blip_animation_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1280.0f, 720.0f}, "resources/graphics/general/blip/", 9);
-	a.black_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1600.0f, 720.0f}, "resources/graphics/black.png", 1);
-
-	a.blip_sound = sound_create("resources/audio/sounds/blip.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 0);
-	a.static_sound = sound_create("resources/audio/sounds/static.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 0);
-
-	a.debug_font = font_create("resources/fonts/minecraftia.ttf");
+	assets_group_create(MEMSTAT_GROUP_GLOBAL, (uint8_t *)&a);
 
 	global_loaded = 1;
 	return a;
@@ -34,18 +416,9 @@ void assets_global_destroy(assets_global_t *a) {
 	if(!global_loaded)
 		return;
 
-	font_destroy(&a->debug_font);
+	assets_group_destroy(MEMSTAT_GROUP_GLOBAL, (uint8_t *)a);
 	font_shader_destroy();
 
-	sound_destroy(&a->static_sound);
-	sound_destroy(&a->blip_sound);
-
-	sprite_destroy(&a->black_sprite);
-	sprite_destroy(&a->blip_animation_sprite);
-	sprite_destroy(&a->static_animation_sprite);
-	sprite_destroy(&a->night_number_sprite);
-	sprite_destroy(&a->night_text_sprite);
-
 	global_loaded = 0;
 }
 
@@ -53,14 +426,7 @@ assets_title_t assets_title_create(void) {
 	assets_title_t a;
 	assert(!title_loaded);
 
-	a.name_sprite = sprite_create((vec2){175.0f, 79.0f}, (vec2){201.0f, 212.0f}, "resources/graphics/title/title-text.png", 1);
-	a.scanline_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1280.0f, 32.0f}, "resources/graphics/general/scanline.png", 1);
-	a.glitchy_blip = sprite_create(GLM_VEC2_ZERO, (vec2){1280.0f, 720.0f}, "resources/graphics/title/glitchy-blip/", 8);
-	a.freddy_face_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1280.0f, 720.0f}, "resources/graphics/title/freddy-face/", 4);
-	a.copyright_sprites = sprite_create(GLM_VEC2_ZERO, GLM_VEC2_ZERO, "resources/graphics/title/copyright/", 2);
-	a.menu_option_sprites = sprite_create((vec2){174.0f, 0.0f}, GLM_VEC2_ZERO, "resources/graphics/title/options/", 6);
-
-	a.music = sound_create("resources/audio/music/title-music.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 1);
+	assets_group_create(MEMSTAT_GROUP_TITLE, (uint8_t *)&a);
 
 	title_loaded = 1;
 	return a;
@@ -70,57 +436,18 @@ void assets_title_destroy(assets_title_t *a) {
 	if(!title_loaded)
 		return;
 
-	sound_destroy(&a->music);
-
-	sprite_destroy(&a->menu_option_sprites);
-	sprite_destroy(&a->copyright_sprites);
-	sprite_destroy(&a->freddy_face_sprite);
-	sprite_destroy(&a->glitchy_blip);
-	sprite_destroy(&a->scanline_sprite);
-	sprite_destroy(&a->name_sprite);
+	assets_group_destroy(MEMSTAT_GROUP_TITLE, (uint8_t *)a);
 
 	title_loaded = 0;
 }
 
-assets_game_t assets_game_create() {
+assets_game_t assets_game_create(void) {
 	assets_game_t a;
-	vec2 door_positions[2] = {{72.0f, -1.0f}, {1270.0f, -2.0f}};
 	assert(!game_loaded);
 
-	for(uint8_t i = 0; i < 2; i++)
-		a.door_animation_sprites[i] = sprite_create(door_positions[i], (vec2){223.0f, 720.0f}, "resources/graphics/office/doors/", 15);
-	a.office_view_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1600.0f, 720.0f}, "resources/graphics/office/states/", 5);
-	a.camera_view_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1600.0f, 720.0f}, "resources/graphics/camera/", 85);
-	a.camera_view_name_sprite = sprite_create((vec2){832.0f, 292.0f}, (vec2){239.0f, 26.0f}, "resources/graphics/ui/camera/map/names/", 11);
-	a.fan_animation_sprite = sprite_create((vec2){780.0f, 303.0f}, (vec2){137.0f, 196.0f}, "resources/graphics/office/fan/", 3);
-	a.door_button_sprites[0] = sprite_create((vec2){6.0f, 263.0f}, (vec2){92.0f, 247.0f}, "resources/graphics/office/doors/buttons/l", 4);
-	a.door_button_sprites[1] = sprite_create((vec2){1497.0f, 273.0f}, (vec2){92.0f, 247.0f}, "resources/graphics/office/doors/buttons/r", 4);
-	a.power_usage_sprite = sprite_create((vec2){120, 657}, (vec2){103, 32}, "resources/graphics/ui/power/levels/", 4);
-	a.power_usage_text_sprite = sprite_create((vec2){38, 667}, (vec2){72, 14}, "resources/graphics/ui/power/usage.png", 1);
-	a.power_left_sprite = sprite_create((vec2){38, 631}, (vec2){137, 14}, "resources/graphics/ui/power/power-left-0.png", 1);
-	a.power_left_percent_sprite = sprite_create((vec2){228, 632}, (vec2){11, 14}, "resources/graphics/ui/power/power-left-1.png", 1);
-	a.power_left_number_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){18, 22}, "resources/graphics/ui/power/numbers/", 10);
-	a.hour_am_sprite = sprite_create((vec2){1200, 31}, (vec2){42, 26}, "resources/graphics/ui/am.png", 1);
-	a.hour_number_sprite = sprite_create((vec2){1161, 29}, (vec2){24, 30}, "resources/graphics/ui/hour/", 6);
-	a.camera_flip_bar_sprite = sprite_create((vec2){255, 638}, (vec2){600, 60}, "resources/graphics/ui/camera/bar.png", 1);
-	a.camera_flip_animation_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1280, 720}, "resources/graphics/ui/camera/flip/", 11);
-	a.camera_border_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){1280, 720}, "resources/graphics/ui/camera/border.png", 1);
-	a.camera_map_sprite = sprite_create((vec2){848.0f, 313.0f}, (vec2){400.0f, 400.0f}, "resources/graphics/ui/camera/map/", 2);
-	a.camera_recording_sprite = sprite_create((vec2){68.0f, 52.0f}, (vec2){50.0f, 50.0f}, "resources/graphics/ui/camera/recording-dot.png", 1);
-	a.camera_button_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){60.0f, 40.0f}, "resources/graphics/ui/camera/map/button/", 2);
-	a.camera_button_name_sprite = sprite_create(GLM_VEC2_ZERO, (vec2){31.0f, 25.0f}, "resources/graphics/ui/camera/map/button/text/", 11);
-	a.camera_disabled_sprite = sprite_create((vec2){464.0f, 69.0f}, (vec2){371.0f, 54.0f}, "resources/graphics/ui/camera/map/disabled.png", 1);
-
-	a.fan_sound = sound_create("resources/audio/sounds/fan.wav", 1.0f, 0.25f, GLM_VEC3_ZERO, 1);
-	a.light_sound = sound_create("resources/audio/sounds/light-hum.wav", 1.0f, 0.0f, GLM_VEC3_ZERO, 1);
-	a.door_sound = sound_create("resources/audio/sounds/door-activate.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 0);
-	a.freddy_nose_sound = sound_create("resources/audio/sounds/boop.wav", 1.0f, 0.4f, GLM_VEC3_ZERO, 0);
-	a.camera_open_sound = sound_create("resources/audio/sounds/cam-open.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 0);
-	a.camera_scan_sound = sound_create("resources/audio/sounds/cam-scan.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 0);
-	a.camera_close_sound = sound_create("resources/audio/sounds/cam-close.wav", 1.0f, 1.0f, GLM_VEC3_ZERO, 0);
+	assets_group_create(MEMSTAT_GROUP_GAME, (uint8_t *)&a);
 
 	game_loaded = 1;
-
 	return a;
 }
 
@@ -128,41 +455,12 @@ void assets_game_destroy(assets_game_t *a) {
 	if(!game_loaded)
 		return;
 
-	sound_destroy(&a->camera_close_sound);
-	sound_destroy(&a->camera_scan_sound);
-	sound_destroy(&a->camera_open_sound);
-	sound_destroy(&a->freddy_nose_sound);
-	sound_destroy(&a->door_sound);
-	sound_destroy(&a->light_sound);
-	sound_destroy(&a->fan_sound);
-
-	sprite_destroy(&a->camera_disabled_sprite);
-	sprite_destroy(&a->camera_button_name_sprite);
-	sprite_destroy(&a->camera_button_sprite);
-	sprite_destroy(&a->camera_recording_sprite);
-	sprite_destroy(&a->camera_map_sprite);
-	sprite_destroy(&a->camera_border_sprite);
-	sprite_destroy(&a->camera_flip_animation_sprite);
-	sprite_destroy(&a->camera_flip_bar_sprite);
-	sprite_destroy(&a->hour_number_sprite);
-	sprite_destroy(&a->hour_am_sprite);
-	sprite_destroy(&a->power_left_number_sprite);
-	sprite_destroy(&a->power_left_percent_sprite);
-	sprite_destroy(&a->power_left_sprite);
-	sprite_destroy(&a->power_usage_text_sprite);
-	sprite_destroy(&a->power_usage_sprite);
-	sprite_destroy(&a->door_button_sprites[1]);
-	sprite_destroy(&a->door_button_sprites[0]);
-	sprite_destroy(&a->fan_animation_sprite);
-	sprite_destroy(&a->camera_view_name_sprite);
-	sprite_destroy(&a->camera_view_sprite);
-	sprite_destroy(&a->office_view_sprite);
-	sprite_destroy(&a->door_animation_sprites[1]);
-	sprite_destroy(&a->door_animation_sprites[0]);
+	assets_group_destroy(MEMSTAT_GROUP_GAME, (uint8_t *)a);
 
 	game_loaded = 0;
 }
 
-void assets_print_loaded() {
+void assets_print_loaded(void) {
 	printf("GLOBAL: %u, TITLE: %u, GAME: %u\n", global_loaded, title_loaded, game_loaded);
+	memstat_print_groups();
 }
@@ -0,0 +1,232 @@
+#include "benchmark.h"
+
+#include "timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+#include "callstat.h"
+#include "heapstat.h"
+
+typedef struct {
+	uint64_t *cpu;
+	uint64_t *gpu;
+	uint32_t gpu_count;
+	#ifdef PROFILE
+		uint64_t calls[CALLSTAT_COUNT];
+	#endif
+} benchmark_samples_t;
+
+typedef struct {
+	double min;
+	double avg;
+	double p50;
+	double p99;
+	double max;
+} benchmark_stats_t;
+
+static const char *scene_names[BENCHMARK_SCENE_COUNT] = {"title", "office", "camera"};
+
+static uint8_t active = 0;
+static uint32_t frames_per_scene = 0;
+static uint8_t scene = 0;
+static uint32_t scene_frame = 0;
+static uint64_t frame_started = 0;
+static benchmark_samples_t samples[BENCHMARK_SCENE_COUNT];
+
+/* a begin and end timestamp per slot */
+static uint32_t queries[BENCHMARK_GPU_LATENCY][2];
+static uint8_t query_recorded[BENCHMARK_GPU_LATENCY];
+static uint8_t query_issued[BENCHMARK_GPU_LATENCY];
+static uint32_t frame_index = 0;
+
+uint8_t benchmark_create(const uint32_t frames) {
+	if(!frames) {
+		printf("ERROR: A benchmark needs at least one frame per scene.\n");
+		return 0;
+	}
+
+	for(uint8_t i = 0; i < BENCHMARK_SCENE_COUNT; i++) {
+		memset(&samples[i], 0, sizeof(benchmark_samples_t));
+		samples[i].cpu = malloc(sizeof(uint64_t) * frames);
+		samples[i].gpu = malloc(sizeof(uint64_t) * frames);
+		#ifdef DEBUG
+			if(!samples[i].cpu || !samples[i].gpu) {
+				printf("ERROR: Benchmark samples fucked up.\n");
+				return 0;
+			}
+		#endif
+	}
+
+	for(uint8_t i = 0; i < BENCHMARK_GPU_LATENCY; i++) {
+		glGenQueries(2, queries[i]);
+		query_issued[i] = 0;
+	}
+
+	frames_per_scene = frames;
+	scene = 0;
+	scene_frame = 0;
+	frame_index = 0;
+	active = 1;
+	return 1;
+}
+
+void benchmark_destroy(void) {
+	if(!active)
+		return;
+
+	for(uint8_t i = 0; i < BENCHMARK_SCENE_COUNT; i++) {
+		free(samples[i].cpu);
+		free(samples[i].gpu);
+	}
+
+	for(uint8_t i = 0; i < BENCHMARK_GPU_LATENCY; i++) {
+		glDeleteQueries(2, queries[i]);
+	}
+	active = 0;
+}
+
+uint8_t benchmark_active(void) {
+	return active;
+}
+
+uint8_t benchmark_scene(void) {
+	return scene;
+}
+
+const char *benchmark_scene_name(const uint8_t index) {
+	return scene_names[index];
+}
+
+static uint8_t benchmark_recording(void) {
+	return scene_frame >= BENCHMARK_WARMUP_FRAMES;
+}
+
+/* blocks until the slot's timestamps are back, the frames are long gone by then */
+static void benchmark_gpu_collect(const uint8_t slot) {
+	GLuint64 begin, end;
+
+	if(!query_issued[slot])
+		return;
+
+	query_issued[slot] = 0;
+	if(!query_recorded[slot])
+		return;
+
+	glGetQueryObjectui64v(queries[slot][0], GL_QUERY_RESULT, &begin);
+	glGetQueryObjectui64v(queries[slot][1], GL_QUERY_RESULT, &end);
+	if(end >= begin) {
+		samples[scene].gpu[samples[scene].gpu_count++] = (uint64_t)(end - begin);
+	}
+}
+
+void benchmark_frame_begin(void) {
+	const uint8_t slot = frame_index % BENCHMARK_GPU_LATENCY;
+
+	/* whatever was in this slot is BENCHMARK_GPU_LATENCY frames old */
+	benchmark_gpu_collect(slot);
+	glQueryCounter(queries[slot][0], GL_TIMESTAMP);
+	frame_started = timer_now_ns();
+}
+
+void benchmark_frame_end(void) {
+	const uint8_t slot = frame_index % BENCHMARK_GPU_LATENCY;
+	const uint64_t elapsed = timer_now_ns() - frame_started;
+
+	glQueryCounter(queries[slot][1], GL_TIMESTAMP);
+	query_issued[slot] = 1;
+	query_recorded[slot] = benchmark_recording();
+	frame_index++;
+
+	if(!benchmark_recording()) {
+		scene_frame++;
+		return;
+	}
+
+	samples[scene].cpu[scene_frame - BENCHMARK_WARMUP_FRAMES] = elapsed;
+	#ifdef PROFILE
+		for(uint8_t i = 0; i < CALLSTAT_COUNT; i++) {
+			samples[scene].calls[i] += callstat_frame_get(i);
+		}
+	#endif
+
+	scene_frame++;
+	if(scene_frame < BENCHMARK_WARMUP_FRAMES + frames_per_scene)
+		return;
+
+	/* the rest of this scene's timestamps have to land in this scene */
+	for(uint8_t i = 0; i < BENCHMARK_GPU_LATENCY; i++) {
+		benchmark_gpu_collect(i);
+	}
+
+	scene++;
+	scene_frame = 0;
+}
+
+static int benchmark_sample_compare(const void *a, const void *b) {
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/* sorts in place, nothing needs the frame order afterwards */
+static benchmark_stats_t benchmark_stats(uint64_t *values, const uint32_t count) {
+	benchmark_stats_t stats = {0.0, 0.0, 0.0, 0.0, 0.0};
+	uint64_t total = 0;
+
+	if(!count)
+		return stats;
+
+	qsort(values, count, sizeof(uint64_t), benchmark_sample_compare);
+	for(uint32_t i = 0; i < count; i++) {
+		total += values[i];
+	}
+
+	stats.min = timer_ms(values[0]);
+	stats.avg = timer_ms(total / count);
+	stats.p50 = timer_ms(values[count / 2]);
+	stats.p99 = timer_ms(values[((uint64_t)count * 99) / 100]);
+	stats.max = timer_ms(values[count - 1]);
+	return stats;
+}
+
+void benchmark_print(void) {
+	if(!active)
+		return;
+
+	printf("BENCHMARK %u frames per scene on %s\n", frames_per_scene, (const char *)glGetString(GL_RENDERER));
+	printf("%-14s %9s %9s %9s %9s %9s\n", "FRAME (ms)", "MIN", "AVG", "P50", "P99", "MAX");
+	for(uint8_t i = 0; i < scene; i++) {
+		const benchmark_stats_t cpu = benchmark_stats(samples[i].cpu, frames_per_scene);
+		const benchmark_stats_t gpu = benchmark_stats(samples[i].gpu, samples[i].gpu_count);
+		char label[32];
+
+		snprintf(label, sizeof(label), "%s cpu", scene_names[i]);
+		printf("%-14s %9.3f %9.3f %9.3f %9.3f %9.3f\n", label, cpu.min, cpu.avg, cpu.p50, cpu.p99, cpu.max);
+
+		snprintf(label, sizeof(label), "%s gpu", scene_names[i]);
+		if(samples[i].gpu_count) {
+			printf("%-14s %9.3f %9.3f %9.3f %9.3f %9.3f\n", label, gpu.min, gpu.avg, gpu.p50, gpu.p99, gpu.max);
+		} else {
+			printf("%-14s %9s %9s %9s %9s %9s\n", label, "-", "-", "-", "-", "-");
+		}
+	}
+
+	#ifdef PROFILE
+		printf("%-14s", "PER FRAME");
+		for(uint8_t i = 0; i < CALLSTAT_COUNT; i++) {
+			printf(" %12s", callstat_name(i));
+		}
+		printf("\n");
+
+		for(uint8_t i = 0; i < scene; i++) {
+			printf("%-14s", scene_names[i]);
+			for(uint8_t j = 0; j < CALLSTAT_COUNT; j++) {
+				printf(" %12.1f", (double)samples[i].calls[j] / (double)frames_per_scene);
+			}
+			printf("\n");
+		}
+	#endif
+}
@@ -0,0 +1,153 @@
+#include "cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heapstat.h"
+
+typedef struct {
+	char *path;
+	cache_destroy_t destroy;
+	uint64_t variant;
+	uint64_t size;
+	uint64_t last_released;
+	uint32_t path_hash;
+	uint32_t handle;
+	uint32_t references;
+	uint8_t kind;
+} cache_entry_t;
+
+static cache_entry_t *entries = NULL;
+static uint32_t entry_count = 0;
+static uint32_t entry_capacity = 0;
+static uint64_t unreferenced_size = 0;
+static uint64_t release_tick = 0;
+
+static uint32_t cache_path_hash(const char *path) {
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	for(const char *c = path; *c; c++) {
+		hash ^= (uint8_t)*c;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static void cache_entry_remove(const uint32_t index) {
+	cache_entry_t *entry = &entries[index];
+
+	entry->destroy(entry->handle);
+	free(entry->path);
+	entries[index] = entries[--entry_count];
+}
+
+static void cache_trim(const uint64_t budget) {
+	while(unreferenced_size > budget) {
+		uint32_t oldest = entry_count;
+		for(uint32_t i = 0; i < entry_count; i++) {
+			if(entries[i].references)
+				continue;
+
+			if(oldest == entry_count || entries[i].last_released < entries[oldest].last_released) {
+				oldest = i;
+			}
+		}
+
+		if(oldest == entry_count)
+			break;
+
+		unreferenced_size -= entries[oldest].size;
+		cache_entry_remove(oldest);
+	}
+}
+
+uint32_t cache_acquire(const uint8_t kind, const char *path, const uint64_t variant) {
+	const uint32_t path_hash = cache_path_hash(path);
+
+	for(uint32_t i = 0; i < entry_count; i++) {
+		cache_entry_t *entry = &entries[i];
+		if(entry->kind != kind || entry->path_hash != path_hash || entry->variant != variant || strcmp(entry->path, path))
+			continue;
+
+		if(!entry->references) {
+			unreferenced_size -= entry->size;
+		}
+
+		entry->references++;
+		return entry->handle;
+	}
+
+	return 0;
+}
+
+void cache_insert(const uint8_t kind, const char *path, const uint64_t variant, const uint32_t handle, const uint64_t size, cache_destroy_t destroy) {
+	cache_entry_t *entry;
+
+	if(entry_count == entry_capacity) {
+		entry_capacity = entry_capacity ? entry_capacity * 2 : 256;
+		entries = realloc(entries, entry_capacity * sizeof(cache_entry_t));
+	}
+
+	entry = &entries[entry_count++];
+	entry->path = malloc(strlen(path) + 1);
+	strcpy(entry->path, path);
+	entry->destroy = destroy;
+	entry->variant = variant;
+	entry->size = size;
+	entry->last_released = 0;
+	entry->path_hash = cache_path_hash(path);
+	entry->handle = handle;
+	entry->references = 1;
+	entry->kind = kind;
+}
+
+uint8_t cache_release(const uint8_t kind, const uint32_t handle) {
+	for(uint32_t i = 0; i < entry_count; i++) {
+		cache_entry_t *entry = &entries[i];
+		if(entry->kind != kind || entry->handle != handle)
+			continue;
+
+		#ifdef DEBUG
+			if(!entry->references) {
+				printf("ERROR: Cache entry '%s' released too many times.\n", entry->path);
+				return 1;
+			}
+		#endif
+
+		entry->references--;
+		if(!entry->references) {
+			entry->last_released = ++release_tick;
+			unreferenced_size += entry->size;
+			cache_trim(CACHE_RESIDENT_BUDGET);
+		}
+
+		return 1;
+	}
+
+	return 0;
+}
+
+void cache_flush(void) {
+	cache_trim(0);
+}
+
+void cache_destroy(void) {
+	#ifdef DEBUG
+		for(uint32_t i = 0; i < entry_count; i++) {
+			if(entries[i].references) {
+				printf("WARNING: '%s' still has %u references.\n", entries[i].path, entries[i].references);
+			}
+		}
+	#endif
+
+	while(entry_count) {
+		cache_entry_remove(entry_count - 1);
+	}
+
+	free(entries);
+	entries = NULL;
+	entry_capacity = 0;
+	unreferenced_size = 0;
+}
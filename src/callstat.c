@@ -0,0 +1,35 @@
+#include "callstat.h"
+
+#ifdef PROFILE
+
+#include <stdio.h>
+
+uint64_t callstat_counters[CALLSTAT_COUNT];
+static uint64_t callstat_last[CALLSTAT_COUNT];
+
+static const char *callstat_names[CALLSTAT_COUNT] = {
+	"draws", "programs", "texture binds", "vao binds", "uniforms", "buffer bytes", "al calls",
+};
+
+void callstat_frame_end(void) {
+	for(uint8_t i = 0; i < CALLSTAT_COUNT; i++) {
+		callstat_last[i] = __atomic_exchange_n(&callstat_counters[i], 0, __ATOMIC_RELAXED);
+	}
+}
+
+uint64_t callstat_frame_get(const uint8_t counter) {
+	return callstat_last[counter];
+}
+
+const char *callstat_name(const uint8_t counter) {
+	return callstat_names[counter];
+}
+
+void callstat_print(void) {
+	printf("LAST FRAME:");
+	for(uint8_t i = 0; i < CALLSTAT_COUNT; i++) {
+		printf(" %s %lu%s", callstat_names[i], (unsigned long)callstat_last[i], (i + 1 < CALLSTAT_COUNT) ? "," : "\n");
+	}
+}
+
+#endif
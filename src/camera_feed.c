@@ -0,0 +1,132 @@
+#include "camera_feed.h"
+#include "job.h"
+
+#include <glad/glad.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "heapstat.h"
+
+static pthread_mutex_t camera_feed_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void camera_feed_load_job(void *data) {
+	camera_feed_frame_t *frame = data;
+	texture_image_t image = texture_image_load(frame->path);
+
+	pthread_mutex_lock(&camera_feed_mutex);
+	frame->image = image;
+	frame->state = image.pixels ? CF_DECODED : CF_FAILED;
+	pthread_mutex_unlock(&camera_feed_mutex);
+}
+
+camera_feed_t camera_feed_create(vec2 pos, vec2 size, const char *path_format, const uint16_t frame_count, const uint64_t budget) {
+	camera_feed_t feed;
+
+	feed.sprite = sprite_create_empty(pos, size, frame_count);
+	feed.frames = calloc(frame_count, sizeof(camera_feed_frame_t));
+	for(uint16_t i = 0; i < frame_count; i++) {
+		sprite_texture_path(path_format, frame_count, i, feed.frames[i].path);
+	}
+
+	feed.budget = budget;
+	feed.resident_size = 0;
+	feed.tick = 1;
+	feed.group = memstat_group_get();
+	snprintf(feed.owner, MEMSTAT_OWNER_LENGTH_MAX, "%s", path_format);
+
+	return feed;
+}
+
+uint8_t camera_feed_request(camera_feed_t *feed, const uint16_t frame) {
+	camera_feed_frame_t *frame_current = &feed->frames[frame];
+	uint8_t state;
+
+	frame_current->last_used = feed->tick;
+
+	pthread_mutex_lock(&camera_feed_mutex);
+	state = frame_current->state;
+	if(state == CF_EMPTY) {
+		frame_current->state = CF_LOADING;
+	}
+	pthread_mutex_unlock(&camera_feed_mutex);
+
+	if(state == CF_EMPTY) {
+		job_submit(camera_feed_load_job, frame_current);
+	}
+
+	return state == CF_RESIDENT;
+}
+
+void camera_feed_update(camera_feed_t *feed) {
+	uint8_t uploads = 0;
+
+	for(uint16_t i = 0; i < feed->sprite.texture_count && uploads < CAMERA_FEED_UPLOADS_PER_FRAME; i++) {
+		camera_feed_frame_t *frame = &feed->frames[i];
+		uint8_t state;
+
+		pthread_mutex_lock(&camera_feed_mutex);
+		state = frame->state;
+		pthread_mutex_unlock(&camera_feed_mutex);
+
+		if(state != CF_DECODED)
+			continue;
+
+		feed->sprite.textures[i] = texture_create_from_image(frame->image, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+		frame->size = (uint32_t)texture_image_size(frame->image);
+		memstat_record(MEMSTAT_TEXTURE, feed->group, feed->owner, feed->sprite.textures[i], frame->size);
+		texture_image_free(&frame->image);
+		frame->state = CF_RESIDENT;
+		feed->resident_size += frame->size;
+		uploads++;
+	}
+
+	/* evict the oldest frames, but never one that was asked for this tick */
+	while(feed->resident_size > feed->budget) {
+		camera_feed_frame_t *oldest = NULL;
+		uint16_t oldest_index = 0;
+
+		for(uint16_t i = 0; i < feed->sprite.texture_count; i++) {
+			camera_feed_frame_t *frame = &feed->frames[i];
+			if(frame->state != CF_RESIDENT || frame->last_used >= feed->tick)
+				continue;
+
+			if(!oldest || frame->last_used < oldest->last_used) {
+				oldest = frame;
+				oldest_index = i;
+			}
+		}
+
+		if(!oldest)
+			break;
+
+		texture_destroy(&feed->sprite.textures[oldest_index]);
+		feed->resident_size -= oldest->size;
+		oldest->state = CF_EMPTY;
+	}
+
+	feed->tick++;
+}
+
+uint8_t camera_feed_draw(camera_feed_t *feed, uint32_t shader, const uint16_t frame) {
+	if(!camera_feed_request(feed, frame))
+		return 0;
+
+	sprite_draw(feed->sprite, shader, frame);
+	return 1;
+}
+
+void camera_feed_destroy(camera_feed_t *feed) {
+	/* loads still in flight write into "frames", so let them land first */
+	job_wait_all();
+
+	for(uint16_t i = 0; i < feed->sprite.texture_count; i++) {
+		if(feed->frames[i].state == CF_DECODED) {
+			texture_image_free(&feed->frames[i].image);
+		}
+	}
+
+	free(feed->frames);
+	sprite_destroy(&feed->sprite);
+	feed->resident_size = 0;
+}
@@ -2,9 +2,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <GLFW/glfw3.h>
 
+#include "heapstat.h"
+
 char *file_load_contents(const char *path) {
 	uint32_t size;
 	FILE *file;
@@ -30,3 +36,71 @@ char *file_load_contents(const char *path) {
 
 	return buffer;
 }
+
+uint8_t *file_load_binary(const char *path, uint64_t *size) {
+	FILE *file;
+	uint8_t *buffer;
+	long length;
+
+	file = fopen(path, "rb");
+	if(!file)
+		return NULL;
+
+	fseek(file, 0L, SEEK_END);
+	length = ftell(file);
+	rewind(file);
+	if(length <= 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	buffer = malloc((size_t)length);
+	if(fread(buffer, 1, (size_t)length, file) != (size_t)length) {
+		free(buffer);
+		fclose(file);
+		return NULL;
+	}
+	fclose(file);
+
+	*size = (uint64_t)length;
+	return buffer;
+}
+
+file_mapping_t file_map(const char *path) {
+	file_mapping_t mapping = {NULL, 0};
+	struct stat file_stat;
+	void *data;
+	int32_t file;
+
+	file = open(path, O_RDONLY);
+	if(file < 0)
+		return mapping;
+
+	if(fstat(file, &file_stat) || file_stat.st_size <= 0) {
+		close(file);
+		return mapping;
+	}
+
+	/* the mapping stays valid after the descriptor is gone */
+	data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	#ifdef DEBUG
+		if(data == MAP_FAILED) {
+			printf("ERROR: File mapping fucked up: %s\n", path);
+		}
+	#endif
+	if(data == MAP_FAILED)
+		return mapping;
+
+	mapping.data = data;
+	mapping.size = (uint64_t)file_stat.st_size;
+	return mapping;
+}
+
+void file_unmap(file_mapping_t *mapping) {
+	if(mapping->data) {
+		munmap(mapping->data, (size_t)mapping->size);
+	}
+	mapping->data = NULL;
+	mapping->size = 0;
+}
@@ -3,10 +3,14 @@
 #include <glad/glad.h>
 #include <cglm/cglm.h>
 #include "shader.h"
+#include "memstat.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include "callstat.h"
+#include "heapstat.h"
+
 static shader_t font_shader;
 
 void font_shader_create() {
@@ -57,6 +61,7 @@ font_t font_create(const char *path) {
 		glm_ivec2_copy((ivec2){(int32_t)face->glyph->bitmap.width, (int32_t)face->glyph->bitmap.rows}, font.characters[c].size);
 		glm_ivec2_copy((ivec2){(int32_t)face->glyph->bitmap_left, (int32_t)face->glyph->bitmap_top}, font.characters[c].bearing);
 		font.characters[c].advance = (uint32_t)face->glyph->advance.x;
+		memstat_record(MEMSTAT_GLYPH, memstat_group_get(), path, font.characters[c].texture, (uint64_t)face->glyph->bitmap.width * face->glyph->bitmap.rows);
 	}
 
 	FT_Done_Face(face);
@@ -111,9 +116,16 @@ void font_draw(const font_t font, const char *string, float *pos, const float *c
 
 void font_destroy(font_t *font) {
 	for(uint8_t i = 0; i < 128; i++) {
+		memstat_release(MEMSTAT_GLYPH, font->characters[i].texture);
 		glDeleteTextures(1, &font->characters[i].texture);
 	}
 	free(font->characters);
+	font->characters = NULL;
+
+	glDeleteBuffers(1, &font->vbo);
+	glDeleteVertexArrays(1, &font->vao);
+	font->vbo = 0;
+	font->vao = 0;
 }
 
 void font_shader_destroy() {
@@ -0,0 +1,115 @@
+#include "frametime.h"
+#include "timer.h"
+
+#include <stdio.h>
+
+static uint32_t buckets[FRAMETIME_BUCKET_COUNT];
+static uint64_t frame_count = 0;
+static uint64_t frame_total = 0;
+static uint64_t frame_max = 0;
+static uint64_t frame_last = 0;
+static uint64_t frame_elapsed = 0;
+static FILE *csv = NULL;
+
+/* anything under FRAMETIME_SUB_BUCKET_COUNT microseconds gets its own bucket, past that they double in width */
+static uint16_t frametime_bucket(const uint64_t us) {
+	uint8_t shift;
+
+	if(us < FRAMETIME_SUB_BUCKET_COUNT)
+		return (uint16_t)us;
+
+	shift = (uint8_t)(63 - __builtin_clzll(us) - FRAMETIME_SUB_BUCKET_BITS + 1);
+	if(shift > FRAMETIME_BUCKET_COUNT / (FRAMETIME_SUB_BUCKET_COUNT / 2) - 2)
+		return FRAMETIME_BUCKET_COUNT - 1;
+
+	return (uint16_t)(shift * (FRAMETIME_SUB_BUCKET_COUNT / 2) + (us >> shift));
+}
+
+/* the top of the bucket, so a percentile never reads lower than it was */
+static uint64_t frametime_bucket_value(const uint16_t bucket) {
+	uint8_t shift;
+	uint64_t sub;
+
+	if(bucket < FRAMETIME_SUB_BUCKET_COUNT)
+		return bucket;
+
+	shift = (uint8_t)(bucket / (FRAMETIME_SUB_BUCKET_COUNT / 2) - 1);
+	sub = bucket % (FRAMETIME_SUB_BUCKET_COUNT / 2) + (FRAMETIME_SUB_BUCKET_COUNT / 2);
+	return ((sub + 1) << shift) - 1;
+}
+
+uint8_t frametime_create(const char *csv_path) {
+	if(!csv_path)
+		return 1;
+
+	csv = fopen(csv_path, "w");
+	if(!csv) {
+		printf("ERROR: Couldn't open '%s' to write frame times to.\n", csv_path);
+		return 0;
+	}
+	fprintf(csv, "frame,ms,state,camera_state\n");
+	return 1;
+}
+
+void frametime_destroy(void) {
+	if(csv) {
+		fclose(csv);
+		csv = NULL;
+	}
+}
+
+void frametime_frame(const char *state, const char *camera_state) {
+	const uint64_t now = timer_now_ns();
+	uint64_t elapsed;
+
+	if(!frame_last) {
+		frame_last = now;
+		return;
+	}
+
+	elapsed = now - frame_last;
+	frame_last = now;
+	frame_elapsed = elapsed;
+
+	buckets[frametime_bucket(elapsed / 1000)]++;
+	frame_total += elapsed;
+	if(elapsed > frame_max) {
+		frame_max = elapsed;
+	}
+
+	if(csv) {
+		fprintf(csv, "%lu,%.3f,%s,%s\n", (unsigned long)frame_count, timer_ms(elapsed), state, camera_state);
+	}
+	frame_count++;
+}
+
+uint64_t frametime_last(void) {
+	return frame_elapsed;
+}
+
+/* smallest value that at least "fraction" of all frames came in under */
+static double frametime_percentile(const double fraction) {
+	const uint64_t target = (uint64_t)((double)frame_count * fraction + 0.5);
+	uint64_t seen = 0;
+
+	for(uint16_t i = 0; i < FRAMETIME_BUCKET_COUNT; i++) {
+		seen += buckets[i];
+		/* the top of the last bucket can be past anything that actually happened */
+		if(seen >= target && seen) {
+			const uint64_t value = frametime_bucket_value(i) * 1000;
+			return timer_ms((value < frame_max) ? value : frame_max);
+		}
+	}
+
+	return timer_ms(frame_max);
+}
+
+void frametime_print(void) {
+	if(!frame_count)
+		return;
+
+	printf("FRAME TIMES over %lu frames (ms)\n", (unsigned long)frame_count);
+	printf("%9s %9s %9s %9s %9s %9s\n", "AVG", "P50", "P90", "P99", "P99.9", "MAX");
+	printf("%9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", timer_ms(frame_total / frame_count), frametime_percentile(0.5),
+		frametime_percentile(0.9), frametime_percentile(0.99), frametime_percentile(0.999), timer_ms(frame_max));
+}
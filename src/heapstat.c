@@ -0,0 +1,220 @@
+#include "heapstat.h"
+
+#ifdef DEBUG
+
+#include "memstat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+/* Catches frees of things that never went through here */
+#define HEAPSTAT_MAGIC			0x48454150u
+
+/* Keeps whatever comes after the block header aligned like malloc would */
+#define HEAPSTAT_HEADER_SIZE	((sizeof(heapstat_block_t) + 15) & ~(size_t)15)
+
+typedef struct heapstat_block_t {
+	struct heapstat_block_t *previous;
+	struct heapstat_block_t *next;
+	const char *file;
+	uint64_t size;
+	uint32_t line;
+	uint32_t magic;
+	uint8_t group;
+} heapstat_block_t;
+
+typedef struct {
+	const char *file;
+	uint64_t size;
+	uint32_t line;
+	uint32_t count;
+	uint8_t group;
+} heapstat_site_t;
+
+static heapstat_block_t *blocks = NULL;
+static uint64_t live_bytes = 0;
+static pthread_mutex_t heapstat_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_t main_thread;
+static uint8_t steady = 0;
+static uint32_t frame_allocations = 0;
+static const char *frame_file = NULL;
+static uint32_t frame_line = 0;
+
+static const char *group_names[MEMSTAT_GROUP_COUNT] = {"GLOBAL", "TITLE", "GAME"};
+
+/* Takes the lock */
+static void *heapstat_track(heapstat_block_t *block, const size_t size, const char *file, const uint32_t line) {
+	if(!block)
+		return NULL;
+
+	block->file = file;
+	block->line = line;
+	block->size = size;
+	block->group = memstat_group_get();
+	block->magic = HEAPSTAT_MAGIC;
+
+	pthread_mutex_lock(&heapstat_mutex);
+	block->previous = NULL;
+	block->next = blocks;
+	if(blocks) {
+		blocks->previous = block;
+	}
+	blocks = block;
+	live_bytes += size;
+
+	if(steady && pthread_equal(pthread_self(), main_thread)) {
+		frame_allocations++;
+		frame_file = file;
+		frame_line = line;
+	}
+	pthread_mutex_unlock(&heapstat_mutex);
+
+	return (uint8_t *)block + HEAPSTAT_HEADER_SIZE;
+}
+
+/* Returns the block, or NULL when "data" never came from here. Takes the lock */
+static heapstat_block_t *heapstat_untrack(void *data) {
+	heapstat_block_t *block = (heapstat_block_t *)((uint8_t *)data - HEAPSTAT_HEADER_SIZE);
+
+	if(block->magic != HEAPSTAT_MAGIC) {
+		printf("ERROR: %p was freed but never allocated through heapstat.\n", data);
+		return NULL;
+	}
+
+	pthread_mutex_lock(&heapstat_mutex);
+	if(block->previous) {
+		block->previous->next = block->next;
+	} else {
+		blocks = block->next;
+	}
+
+	if(block->next) {
+		block->next->previous = block->previous;
+	}
+	live_bytes -= block->size;
+	pthread_mutex_unlock(&heapstat_mutex);
+
+	block->magic = 0;
+	return block;
+}
+
+/* The parentheses keep the real allocator from expanding into the macros in heapstat.h */
+void *heapstat_malloc(const size_t size, const char *file, const uint32_t line) {
+	return heapstat_track((malloc)(HEAPSTAT_HEADER_SIZE + size), size, file, line);
+}
+
+void *heapstat_calloc(const size_t count, const size_t size, const char *file, const uint32_t line) {
+	if(size && count > (SIZE_MAX - HEAPSTAT_HEADER_SIZE) / size)
+		return NULL;
+
+	return heapstat_track((calloc)(1, HEAPSTAT_HEADER_SIZE + (count * size)), count * size, file, line);
+}
+
+void *heapstat_realloc(void *data, const size_t size, const char *file, const uint32_t line) {
+	heapstat_block_t *block, *moved;
+
+	if(!data)
+		return heapstat_malloc(size, file, line);
+
+	block = heapstat_untrack(data);
+	if(!block)
+		return NULL;
+
+	/* a failed realloc leaves the old block alone, so it goes straight back on the list */
+	moved = (realloc)(block, HEAPSTAT_HEADER_SIZE + size);
+	if(!moved) {
+		heapstat_track(block, block->size, block->file, block->line);
+		return NULL;
+	}
+
+	return heapstat_track(moved, size, file, line);
+}
+
+void heapstat_free(void *data) {
+	heapstat_block_t *block;
+	if(!data)
+		return;
+
+	block = heapstat_untrack(data);
+	if(block) {
+		(free)(block);
+	}
+}
+
+void heapstat_steady_set(const uint8_t state) {
+	pthread_mutex_lock(&heapstat_mutex);
+	main_thread = pthread_self();
+	steady = state;
+	frame_allocations = 0;
+	pthread_mutex_unlock(&heapstat_mutex);
+}
+
+uint32_t heapstat_frame_check(void) {
+	uint32_t count;
+
+	pthread_mutex_lock(&heapstat_mutex);
+	count = frame_allocations;
+	if(count) {
+		printf("ERROR: The main loop allocated %u times in one frame, the last at %s:%u.\n", count, frame_file, frame_line);
+	}
+	frame_allocations = 0;
+	pthread_mutex_unlock(&heapstat_mutex);
+
+	return count;
+}
+
+uint64_t heapstat_live_bytes(void) {
+	uint64_t bytes;
+
+	pthread_mutex_lock(&heapstat_mutex);
+	bytes = live_bytes;
+	pthread_mutex_unlock(&heapstat_mutex);
+
+	return bytes;
+}
+
+void heapstat_print(const char *title) {
+	heapstat_site_t sites[HEAPSTAT_SITE_MAX];
+	uint32_t site_count = 0;
+	uint32_t block_count = 0;
+
+	pthread_mutex_lock(&heapstat_mutex);
+	for(heapstat_block_t *block = blocks; block; block = block->next) {
+		heapstat_site_t *site = NULL;
+		block_count++;
+
+		for(uint32_t i = 0; i < site_count; i++) {
+			if(sites[i].line == block->line && sites[i].group == block->group && sites[i].file == block->file) {
+				site = &sites[i];
+				break;
+			}
+		}
+
+		if(!site) {
+			if(site_count == HEAPSTAT_SITE_MAX)
+				continue;
+
+			site = &sites[site_count++];
+			site->file = block->file;
+			site->line = block->line;
+			site->group = block->group;
+			site->size = 0;
+			site->count = 0;
+		}
+
+		site->size += block->size;
+		site->count++;
+	}
+
+	printf("%s: %lu bytes in %u allocations\n", title, (unsigned long)live_bytes, block_count);
+	for(uint32_t i = 0; i < site_count; i++) {
+		char location[64];
+		snprintf(location, sizeof(location), "%s:%u", sites[i].file, sites[i].line);
+		printf("    %-32s %-6s %10lu bytes in %u\n", location, group_names[sites[i].group], (unsigned long)sites[i].size, sites[i].count);
+	}
+	pthread_mutex_unlock(&heapstat_mutex);
+}
+
+#endif
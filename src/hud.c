@@ -0,0 +1,232 @@
+#include "hud.h"
+#include "shader.h"
+#include "timer.h"
+#include "frametime.h"
+#include "memstat.h"
+#include "profile.h"
+
+/* before glad, so none of the HUD's own calls get counted */
+#include "callstat.h"
+
+#include <stddef.h>
+#include <glad/glad.h>
+
+#define HUD_MARGIN					16.0f
+
+enum {
+	HUD_GRAPH_TEXTURE = 0,
+	HUD_GRAPH_FRAME,
+	#ifdef PROFILE
+		HUD_GRAPH_DRAWS,
+		HUD_GRAPH_GPU,
+		HUD_GRAPH_CPU,
+	#endif
+	HUD_GRAPH_COUNT
+};
+
+/* a background line, frame, texture and draw call lines, and every scope twice, per column, plus a guide per graph */
+#define HUD_VERTEX_MAX				(2 * (HUD_HISTORY_LENGTH * (HUD_GRAPH_COUNT + 3 + 2 * PROFILE_SCOPE_COUNT) + HUD_GRAPH_COUNT))
+
+typedef struct {
+	float position[2];
+	uint8_t color[4];
+} hud_vertex_t;
+
+typedef struct {
+	float frame_ms;
+	float texture_mb;
+	#ifdef PROFILE
+		float draws;
+		float cpu_ms[PROFILE_SCOPE_COUNT];
+		float gpu_ms[PROFILE_SCOPE_COUNT];
+	#endif
+} hud_sample_t;
+
+static const uint8_t color_background[4] = {0, 0, 0, 160};
+static const uint8_t color_guide[4] = {255, 255, 255, 72};
+static const uint8_t color_frame[4] = {255, 255, 255, 255};
+static const uint8_t color_texture[4] = {80, 160, 255, 255};
+
+#ifdef PROFILE
+	static const uint8_t color_draws[4] = {255, 160, 40, 255};
+
+	/* the title and game draws never run in the same frame, so they can share */
+	static const uint8_t color_scopes[PROFILE_SCOPE_COUNT][4] = {
+		{0, 0, 0, 0},
+		{200, 200, 200, 255},
+		{255, 220, 0, 255},
+		{80, 220, 80, 255},
+		{80, 220, 80, 255},
+		{60, 160, 255, 255},
+		{220, 80, 220, 255},
+		{255, 80, 80, 255},
+	};
+#endif
+
+static uint8_t visible = 0;
+static float origin_x = 0.0f;
+static shader_t hud_shader;
+static uint32_t vao;
+static uint32_t vbo;
+
+static hud_sample_t samples[HUD_HISTORY_LENGTH];
+static uint16_t sample_next = 0;
+static uint16_t sample_count = 0;
+
+static hud_vertex_t vertices[HUD_VERTEX_MAX];
+static uint32_t vertex_count = 0;
+
+void hud_create(const float width) {
+	origin_x = width - HUD_HISTORY_LENGTH - HUD_MARGIN;
+	hud_shader = shader_create("resources/shaders/hud_vertex.glsl", "resources/shaders/hud_fragment.glsl");
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), NULL, GL_STREAM_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(hud_vertex_t), NULL);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(hud_vertex_t), (void *)(2 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void hud_destroy(void) {
+	glDeleteBuffers(1, &vbo);
+	glDeleteVertexArrays(1, &vao);
+	glDeleteProgram(hud_shader);
+}
+
+void hud_toggle(void) {
+	visible = !visible;
+	sample_next = 0;
+	sample_count = 0;
+}
+
+static void hud_record(void) {
+	hud_sample_t *sample = &samples[sample_next];
+
+	sample->frame_ms = (float)timer_ms(frametime_last());
+	sample->texture_mb = (float)(memstat_kind_total(MEMSTAT_TEXTURE) + memstat_kind_total(MEMSTAT_GLYPH)) / (1024.0f * 1024.0f);
+	#ifdef PROFILE
+		sample->draws = (float)callstat_frame_get(CALLSTAT_DRAW);
+		for(uint8_t i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+			sample->cpu_ms[i] = (float)timer_ms(profile_last(i));
+			sample->gpu_ms[i] = (float)timer_ms(profile_gpu_last(i));
+		}
+	#endif
+
+	sample_next = (sample_next + 1) % HUD_HISTORY_LENGTH;
+	if(sample_count < HUD_HISTORY_LENGTH) {
+		sample_count++;
+	}
+}
+
+static void hud_vertex(const float x, const float y, const uint8_t *color) {
+	hud_vertex_t *vertex = &vertices[vertex_count++];
+	vertex->position[0] = x;
+	vertex->position[1] = y;
+	for(uint8_t i = 0; i < 4; i++) {
+		vertex->color[i] = color[i];
+	}
+}
+
+/* a column in graph "graph" from "from" to "to", both 0 to 1 of its height, cut off at the top */
+static void hud_column(const uint8_t graph, const float column, float from, float to, const uint8_t *color) {
+	const float x = origin_x + column + 0.5f;
+	const float y = HUD_MARGIN + (float)graph * (HUD_GRAPH_HEIGHT + HUD_GRAPH_GAP);
+
+	from = (from > 1.0f) ? 1.0f : from;
+	to = (to > 1.0f) ? 1.0f : to;
+	if(to <= from)
+		return;
+
+	hud_vertex(x, y + from * HUD_GRAPH_HEIGHT, color);
+	hud_vertex(x, y + to * HUD_GRAPH_HEIGHT, color);
+}
+
+static void hud_guide(const uint8_t graph, const float height) {
+	const float y = HUD_MARGIN + (float)graph * (HUD_GRAPH_HEIGHT + HUD_GRAPH_GAP) + height * HUD_GRAPH_HEIGHT + 0.5f;
+	hud_vertex(origin_x, y, color_guide);
+	hud_vertex(origin_x + HUD_HISTORY_LENGTH, y, color_guide);
+}
+
+#ifdef PROFILE
+/* every scope but the whole frame, one on top of the other */
+static void hud_stack(const uint8_t graph, const float column, const float *scope_ms) {
+	float height = 0.0f;
+	for(uint8_t i = PROFILE_FRAME + 1; i < PROFILE_SCOPE_COUNT; i++) {
+		const float top = height + scope_ms[i] / HUD_TIME_SCALE_MS;
+		hud_column(graph, column, height, top, color_scopes[i]);
+		height = top;
+	}
+}
+#endif
+
+/* the biggest value in view gets most of the height, but nothing gets blown up from next to zero */
+static float hud_scale(const float largest, const float floor) {
+	return 1.0f / (((largest > floor) ? largest : floor) * 1.25f);
+}
+
+void hud_draw(const float *projection) {
+	float texture_scale = 0.0f;
+	#ifdef PROFILE
+		float draws_scale = 0.0f;
+	#endif
+
+	if(!visible)
+		return;
+
+	hud_record();
+
+	for(uint16_t i = 0; i < sample_count; i++) {
+		texture_scale = (samples[i].texture_mb > texture_scale) ? samples[i].texture_mb : texture_scale;
+		#ifdef PROFILE
+			draws_scale = (samples[i].draws > draws_scale) ? samples[i].draws : draws_scale;
+		#endif
+	}
+	texture_scale = hud_scale(texture_scale, 1.0f);
+	#ifdef PROFILE
+		draws_scale = hud_scale(draws_scale, 10.0f);
+	#endif
+
+	vertex_count = 0;
+	for(uint16_t column = 0; column < HUD_HISTORY_LENGTH; column++) {
+		for(uint8_t graph = 0; graph < HUD_GRAPH_COUNT; graph++) {
+			hud_column(graph, column, 0.0f, 1.0f, color_background);
+		}
+	}
+
+	/* oldest on the left, the newest frame is always the rightmost column */
+	for(uint16_t i = 0; i < sample_count; i++) {
+		const hud_sample_t *sample = &samples[(sample_next + HUD_HISTORY_LENGTH - sample_count + i) % HUD_HISTORY_LENGTH];
+		const float column = (float)(HUD_HISTORY_LENGTH - sample_count + i);
+
+		hud_column(HUD_GRAPH_TEXTURE, column, 0.0f, sample->texture_mb * texture_scale, color_texture);
+		hud_column(HUD_GRAPH_FRAME, column, 0.0f, sample->frame_ms / HUD_TIME_SCALE_MS, color_frame);
+		#ifdef PROFILE
+			hud_column(HUD_GRAPH_DRAWS, column, 0.0f, sample->draws * draws_scale, color_draws);
+			hud_stack(HUD_GRAPH_GPU, column, sample->gpu_ms);
+			hud_stack(HUD_GRAPH_CPU, column, sample->cpu_ms);
+		#endif
+	}
+
+	hud_guide(HUD_GRAPH_FRAME, 0.5f);
+	#ifdef PROFILE
+		hud_guide(HUD_GRAPH_GPU, 0.5f);
+		hud_guide(HUD_GRAPH_CPU, 0.5f);
+	#endif
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(vertex_count * sizeof(hud_vertex_t)), vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glUseProgram(hud_shader);
+	glUniformMatrix4fv(glGetUniformLocation(hud_shader, "projection"), 1, GL_FALSE, projection);
+	glBindVertexArray(vao);
+	glDrawArrays(GL_LINES, 0, (GLsizei)vertex_count);
+	glBindVertexArray(0);
+}
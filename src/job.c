@@ -0,0 +1,105 @@
+#include "job.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <pthread.h>
+#include <assert.h>
+
+typedef struct {
+	job_function_t function;
+	void *data;
+} job_t;
+
+static pthread_t job_threads[JOB_THREAD_COUNT_MAX];
+static uint8_t job_thread_count = 0;
+
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_queue_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_done_cond = PTHREAD_COND_INITIALIZER;
+
+static job_t job_queue[JOB_QUEUE_SIZE];
+static uint32_t job_queue_head = 0;
+static uint32_t job_queue_tail = 0;
+static uint32_t job_pending_count = 0;
+static uint8_t job_system_running = 0;
+
+static void *job_thread_main(void *arg) {
+	char name[16];
+
+	snprintf(name, sizeof(name), "job %u", (uint32_t)(uintptr_t)arg);
+	trace_thread_name(name);
+
+	pthread_mutex_lock(&job_mutex);
+	for(;;) {
+		job_t job;
+		while(job_system_running && job_queue_head == job_queue_tail) {
+			pthread_cond_wait(&job_queue_cond, &job_mutex);
+		}
+
+		if(job_queue_head == job_queue_tail) {
+			break;
+		}
+
+		job = job_queue[job_queue_head % JOB_QUEUE_SIZE];
+		job_queue_head++;
+		pthread_mutex_unlock(&job_mutex);
+
+		job.function(job.data);
+
+		pthread_mutex_lock(&job_mutex);
+		job_pending_count--;
+		if(!job_pending_count) {
+			pthread_cond_broadcast(&job_done_cond);
+		}
+	}
+	pthread_mutex_unlock(&job_mutex);
+
+	return NULL;
+}
+
+void job_system_create(const uint8_t thread_count) {
+	assert(!job_thread_count);
+
+	job_system_running = 1;
+	job_thread_count = (thread_count > JOB_THREAD_COUNT_MAX) ? JOB_THREAD_COUNT_MAX : thread_count;
+	for(uint8_t i = 0; i < job_thread_count; i++) {
+		pthread_create(&job_threads[i], NULL, job_thread_main, (void *)(uintptr_t)i);
+	}
+}
+
+void job_system_destroy(void) {
+	pthread_mutex_lock(&job_mutex);
+	job_system_running = 0;
+	pthread_cond_broadcast(&job_queue_cond);
+	pthread_mutex_unlock(&job_mutex);
+
+	for(uint8_t i = 0; i < job_thread_count; i++) {
+		pthread_join(job_threads[i], NULL);
+	}
+	job_thread_count = 0;
+}
+
+void job_submit(job_function_t function, void *data) {
+	pthread_mutex_lock(&job_mutex);
+
+	/* queue is full, so just do it ourselves */
+	if(!job_thread_count || job_queue_tail - job_queue_head >= JOB_QUEUE_SIZE) {
+		pthread_mutex_unlock(&job_mutex);
+		function(data);
+		return;
+	}
+
+	job_queue[job_queue_tail % JOB_QUEUE_SIZE] = (job_t){function, data};
+	job_queue_tail++;
+	job_pending_count++;
+	pthread_cond_signal(&job_queue_cond);
+	pthread_mutex_unlock(&job_mutex);
+}
+
+void job_wait_all(void) {
+	pthread_mutex_lock(&job_mutex);
+	while(job_pending_count) {
+		pthread_cond_wait(&job_done_cond, &job_mutex);
+	}
+	pthread_mutex_unlock(&job_mutex);
+}
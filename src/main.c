@@ -18,6 +18,22 @@
 #include "sound.h"
 #include "shader.h"
 #include "helpers.h"
+#include "job.h"
+#include "memstat.h"
+#include "upload.h"
+#include "cache.h"
+#include "sound_latency.h"
+#include "sound_loopback.h"
+#include "profile.h"
+#include "trace.h"
+#include "startup.h"
+#include "platform.h"
+#include "benchmark.h"
+#include "frametime.h"
+#include "hud.h"
+
+#include "callstat.h"
+#include "heapstat.h"
 
 #ifdef DEBUG
 	#define TIME_MULTIPLIER 			32	
@@ -34,7 +50,11 @@
 
 #define CAM_TIMER_INIT 					0.35f
 
-static GLFWwindow *window;
+#define JOB_THREAD_COUNT				4
+
+/* benchmarks run without a sound card unless they ask for one */
+#define BENCHMARK_LOOPBACK_FREQUENCY	44100
+
 static uint8_t mouse_has_clicked = 0;
 
 static float scaled_update_timer = 0.0f;
@@ -79,6 +99,8 @@ static uint8_t camera_bar_hovering = 0;
 static uint8_t camera_state = CS_CLOSED;
 static uint8_t camera_selected = 0;
 static float camera_flip_timer = CAM_TIMER_INIT;
+static uint8_t camera_feed_missing = 0;
+static const uint8_t camera_selected_offsets[11] = { 0, 7, 13, 18, 54, 60, 62, 68, 77, 0, 81 };
 
 static float title_timer1 = 0.0f;
 static float title_timer2 = 0.0f;
@@ -91,6 +113,13 @@ static uint8_t light_flicker;
 
 static float office_look_current = -160.0f;
 static uint8_t space_pressed = 0;
+static uint8_t memstat_key_pressed = 0;
+static uint8_t latency_key_pressed = 0;
+#ifdef PROFILE
+	static uint8_t profile_key_pressed = 0;
+#endif
+static uint8_t frametime_key_pressed = 0;
+static uint8_t hud_key_pressed = 0;
 
 static float camera_look_current = 0.0f;
 static float camera_look_hold_timer = 0.0f;
@@ -109,77 +138,84 @@ enum {
 
 static uint8_t game_state = GS_TITLE;
 
-int main() {
-	/* load GLFW */
-	#ifdef DEBUG
-		if(!glfwInit()) {
-			printf("ERROR: GLFW fucked up.\n");
-			return 1;
-		}
-	#else
-		glfwInit();
-	#endif
-
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, 1);
-
-	/* create window */
-	window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Five Nights at Freddy's", NULL, NULL);
-	#ifdef DEBUG
-		if(!window) {
-			printf("ERROR: Window fucked up.\n");
-			return 1;
-		}
-	#endif
+static sound_config_t sound_config = {0, 0, 0, 0, 0};
+static const char *trace_path = NULL;
+static const char *startup_report_path = NULL;
+static const char *frame_csv_path = NULL;
+static int32_t benchmark_frames = 0;
+static uint8_t benchmark_scene_current = BENCHMARK_SCENE_COUNT;
+
+static const char *game_state_names[] = {"title", "game"};
+static const char *camera_state_names[] = {"camera closed", "camera opening", "camera opened", "camera closing"};
+
+static void options_print_usage(const char *program) {
+	printf("usage: %s [options]\n", program);
+	printf("  --audio-frequency HZ       mixing rate to ask OpenAL for\n");
+	printf("  --audio-refresh HZ         how many times a second the mixer should run\n");
+	printf("  --audio-mono-sources N     how many mono sources to reserve\n");
+	printf("  --audio-stereo-sources N   how many stereo sources to reserve\n");
+	printf("  --audio-loopback HZ        mix into memory at this rate instead of using a sound card\n");
+	printf("  --trace FILE               write a chrome://tracing timeline of the whole run to FILE\n");
+	printf("  --startup-report FILE      write the startup time breakdown to FILE as JSON\n");
+	printf("  --frame-csv FILE           write every frame's time to FILE, with the state it was drawn in\n");
+	printf("  --benchmark N              render N frames of every scene without a window and print the frame times\n");
+}
 
-	{ /* get monitor properties */
-		GLFWmonitor *monitor;
-		ivec2 monitor_size;
-		int32_t monitor_count;
-		monitor = *glfwGetMonitors(&monitor_count);
-		#ifdef DEBUG
-			if(!monitor) {
-				printf("ERROR: Monitor fucked up.\n");
-				glfwDestroyWindow(window);
-				glfwTerminate();
-				return 1;
+static uint8_t options_parse(const int32_t argc, char **argv) {
+	const struct {
+		const char *name;
+		int32_t *value;
+		const char **string;
+	} options[] = {
+		{"--audio-frequency", &sound_config.frequency, NULL},
+		{"--audio-refresh", &sound_config.refresh, NULL},
+		{"--audio-mono-sources", &sound_config.mono_sources, NULL},
+		{"--audio-stereo-sources", &sound_config.stereo_sources, NULL},
+		{"--audio-loopback", &sound_config.loopback_frequency, NULL},
+		{"--trace", NULL, &trace_path},
+		{"--startup-report", NULL, &startup_report_path},
+		{"--frame-csv", NULL, &frame_csv_path},
+		{"--benchmark", &benchmark_frames, NULL},
+	};
+
+	for(int32_t i = 1; i < argc; i++) {
+		uint8_t found = 0;
+		for(uint8_t j = 0; j < sizeof(options) / sizeof(options[0]); j++) {
+			char *end;
+			if(strcmp(argv[i], options[j].name))
+				continue;
+
+			if(i + 1 >= argc) {
+				printf("ERROR: '%s' needs a value.\n", argv[i]);
+				return 0;
 			}
-		#endif
-
-		glfwGetMonitorWorkarea(monitor, NULL, NULL, &monitor_size[0], &monitor_size[1]);
-		glfwSetWindowPos(window, (monitor_size[0] / 2) - (WINDOW_WIDTH / 2), (monitor_size[1] / 2) - (WINDOW_HEIGHT / 2));
-	}
 
-	glfwMakeContextCurrent(window);
+			found = 1;
+			if(options[j].string) {
+				*options[j].string = argv[++i];
+				break;
+			}
 
-	/* load GLAD */
-	#ifdef DEBUG
-		if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-			printf("ERROR: GLAD fucked up.\n");
-			glfwDestroyWindow(window);
-			glfwTerminate();
-			return 1;
+			*options[j].value = (int32_t)strtol(argv[++i], &end, 10);
+			if(*end || *options[j].value < 0) {
+				printf("ERROR: '%s' isn't a valid value for '%s'.\n", argv[i], options[j].name);
+				return 0;
+			}
 		}
-	#else
-		gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
-	#endif
-
-	glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-
-	/* set up matricies */
-	glm_ortho(0.0f, WINDOW_WIDTH, 0.0f, WINDOW_HEIGHT, -1.0f, 1.0f, matrix_projection);
 
-	/* create shaders */
-	render_shader_program = shader_create("resources/shaders/render_vertex.glsl", "resources/shaders/render_fragment.glsl");
-	ui_shader_program = shader_create("resources/shaders/render_ui_vertex.glsl", "resources/shaders/render_ui_fragment.glsl");
-	sprite_shader_program = shader_create("resources/shaders/sprite_vertex.glsl", "resources/shaders/sprite_fragment.glsl");
+		if(!found) {
+			options_print_usage(argv[0]);
+			return 0;
+		}
+	}
 
-	sound_system_create();
+	return 1;
+}
 
-	/* load assets */
-	assets_global = assets_global_create();
+/* Loads what "state" needs and puts it back the way a fresh start would have it */
+static void game_state_enter(const uint8_t state) {
+	game_state = state;
+	trace_instant(game_state_names[game_state], "state");
 	switch(game_state) {
 		case GS_TITLE:
 			assets_title = assets_title_create();
@@ -204,8 +240,141 @@ int main() {
 			camera_look_current = 0.0f;
 			break;
 	}
+}
+
+static void game_state_leave(void) {
+	switch(game_state) {
+		case GS_TITLE:
+			sound_stop(assets_global.blip_sound);
+			sound_stop(assets_global.static_sound);
+			assets_title_destroy(&assets_title);
+			break;
+
+		case GS_GAME:
+			sound_stop(assets_game.light_sound);
+			sound_stop(assets_game.fan_sound);
+			assets_game_destroy(&assets_game);
+			break;
+	}
+}
+
+/* Sets the game up the way the benchmark scene wants it, nothing gets clicked so it's done by hand */
+static void benchmark_scene_enter(const uint8_t scene) {
+	const uint8_t state = (scene == BENCHMARK_TITLE) ? GS_TITLE : GS_GAME;
+
+	#ifdef DEBUG
+		heapstat_steady_set(0);
+	#endif
+	trace_instant(benchmark_scene_name(scene), "benchmark");
+	if(state != game_state) {
+		game_state_leave();
+		game_state_enter(state);
+	}
+
+	if(scene == BENCHMARK_CAMERA) {
+		camera_state = CS_OPENED;
+		camera_feed_request(&assets_game.camera_feed, camera_selected_offsets[camera_selected] + (camera_selected == 3));
+		trace_instant(camera_state_names[camera_state], "state");
+	}
+	benchmark_scene_current = scene;
+	#ifdef DEBUG
+		heapstat_steady_set(1);
+	#endif
+}
+
+#if defined(DEBUG) && defined(PROFILE)
+/* Last frame's driver traffic, two lines going down from "y" */
+static void debug_callstat_draw(const float x, const float y) {
+	char buffers[2][256];
+	sprintf(buffers[0], "    Draws: %lu  Programs: %lu  Textures: %lu  VAOs: %lu",
+		(unsigned long)callstat_frame_get(CALLSTAT_DRAW), (unsigned long)callstat_frame_get(CALLSTAT_PROGRAM),
+		(unsigned long)callstat_frame_get(CALLSTAT_TEXTURE_BIND), (unsigned long)callstat_frame_get(CALLSTAT_VAO_BIND));
+	sprintf(buffers[1], "    Uniforms: %lu  Buffer KB: %.1f  AL: %lu",
+		(unsigned long)callstat_frame_get(CALLSTAT_UNIFORM), (double)callstat_frame_get(CALLSTAT_BUFFER_BYTES) / 1024.0,
+		(unsigned long)callstat_frame_get(CALLSTAT_AL));
+
+	for(uint8_t i = 0; i < 2; i++) {
+		font_draw(assets_global.debug_font, buffers[i], (vec2){x, y - (48.0f * i)}, GLM_VEC3_ONE, 0.6f);
+	}
+}
+#endif
+
+int main(int argc, char **argv) {
+	if(!options_parse(argc, argv)) {
+		return 1;
+	}
+	startup_begin();
+
+	if(trace_path && !trace_create(trace_path)) {
+		return 1;
+	}
+	trace_thread_name("main");
+
+	if(!frametime_create(frame_csv_path)) {
+		trace_destroy();
+		return 1;
+	}
+
+	/* a run that fails to start is the one whose trace you want, so every early return still closes both files */
+	atexit(frametime_destroy);
+	atexit(trace_destroy);
+
+	/* make sure every asset is there before we open anything */
+	if(!assets_manifest_load("resources/assets.manifest")) {
+		return 1;
+	}
+	startup_phase("manifest");
+
+	/* benchmarks don't need a window or a sound card */
+	if(benchmark_frames && !sound_config.loopback_frequency) {
+		sound_config.loopback_frequency = BENCHMARK_LOOPBACK_FREQUENCY;
+	}
+
+	if(!platform_create(benchmark_frames ? PLATFORM_HEADLESS : PLATFORM_WINDOW, WINDOW_WIDTH, WINDOW_HEIGHT, "Five Nights at Freddy's")) {
+		return 1;
+	}
+
+	glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+	upload_system_create();
+	PROFILE_CREATE();
+	if(benchmark_frames && !benchmark_create((uint32_t)benchmark_frames)) {
+		platform_destroy();
+		return 1;
+	}
+
+	/* set up matricies */
+	glm_ortho(0.0f, WINDOW_WIDTH, 0.0f, WINDOW_HEIGHT, -1.0f, 1.0f, matrix_projection);
+
+	/* create shaders */
+	render_shader_program = shader_create("resources/shaders/render_vertex.glsl", "resources/shaders/render_fragment.glsl");
+	startup_phase("render shader");
+	ui_shader_program = shader_create("resources/shaders/render_ui_vertex.glsl", "resources/shaders/render_ui_fragment.glsl");
+	startup_phase("ui shader");
+	sprite_shader_program = shader_create("resources/shaders/sprite_vertex.glsl", "resources/shaders/sprite_fragment.glsl");
+	startup_phase("sprite shader");
+	hud_create(WINDOW_WIDTH);
+	startup_phase("hud shader");
+
+	if(!sound_system_create(sound_config)) {
+		platform_destroy();
+		return 1;
+	}
+	startup_phase("sound system");
+	job_system_create(JOB_THREAD_COUNT);
+	startup_phase("job system");
+
+	/* load assets */
+	assets_global = assets_global_create();
+	startup_phase("global assets");
+	game_state_enter(game_state);
+	startup_phase((game_state == GS_TITLE) ? "title assets" : "game assets");
 	assets_print_loaded();
 
+	/* from here on, frames shouldn't touch the heap until the state changes */
+	#ifdef DEBUG
+		heapstat_steady_set(1);
+	#endif
+
 	/* set up audio listener */
 	alListeneri(AL_DISTANCE_MODEL, AL_INVERSE_DISTANCE_CLAMPED);
 
@@ -268,9 +437,11 @@ int main() {
 		glBindVertexArray(0);
 	}
 
+	startup_phase("gl setup");
+
 	/* main loop */
-	srand((uint32_t)time(NULL));
-	while(!glfwWindowShouldClose(window)) {
+	srand(benchmark_frames ? 0 : (uint32_t)time(NULL));
+	while(!platform_should_close()) {
 		ivec2 mouse_position;
 		mat4 matrix_view;
 
@@ -279,71 +450,116 @@ int main() {
 		float time_delta;
 		float ticks;
 
+		if(benchmark_active()) {
+			const uint8_t scene = benchmark_scene();
+			if(scene == BENCHMARK_SCENE_COUNT)
+				break;
+
+			if(scene != benchmark_scene_current) {
+				benchmark_scene_enter(scene);
+			}
+			benchmark_frame_begin();
+		}
+
+		PROFILE_BEGIN(PROFILE_FRAME);
 
-		time_now = glfwGetTime();
+		time_now = platform_time();
 		time_delta = (float)(time_now - time_last);
 		time_last = time_now;
  		ticks = time_delta * 60.0f;
 
-		if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-			glfwSetWindowShouldClose(window, 1);
+		/* without a sound card nothing pulls the mixer along, so keep it in step with the game */
+		sound_loopback_render(time_delta);
+
+		PROFILE_BEGIN(PROFILE_INPUT);
+		if(platform_key_down(GLFW_KEY_ESCAPE)) {
+			platform_close();
 		}
 
 		#ifdef DEBUG
 		{
-			const float time_multiplier = (float)(glfwGetKey(window, GLFW_KEY_F) * TIME_MULTIPLIER) + 1.0f;
+			const float time_multiplier = (float)(platform_key_down(GLFW_KEY_F) * TIME_MULTIPLIER) + 1.0f;
 			time_delta *= time_multiplier;
 			ticks *= time_multiplier;
 			time_now *= (double)time_multiplier;
 		}
 		#endif
 
-		if(glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && !space_pressed) {
-			game_state = !game_state;
-			switch(game_state) {
-				case GS_TITLE:
-					sound_stop(assets_game.light_sound);
-					sound_stop(assets_game.fan_sound);
-					assets_game_destroy(&assets_game);
-
-					assets_title = assets_title_create();
-					sound_play(assets_global.blip_sound);
-					sound_play(assets_global.static_sound);
-					sound_play(assets_title.music);
-					office_look_current = 0.0f;
-					camera_look_current = 0.0f;
-					break;
-
-				case GS_GAME:
-					sound_stop(assets_global.blip_sound);
-					sound_stop(assets_global.static_sound);
-					assets_title_destroy(&assets_title);
-
-					assets_game = assets_game_create();
-					sound_play(assets_game.fan_sound);
-					sound_play(assets_game.light_sound);
-
-					camera_state = CS_CLOSED;
-					camera_selected = 0;
-					door_button_flags = 0;
-					hour_timer = 0.0f;
-					power_left_value = 99.9f;
-					office_look_current = -160.0f;
-					camera_look_current = 0.0f;
-					night_current++;
-					break;
+		if(platform_key_down(GLFW_KEY_SPACE) && !space_pressed) {
+			#ifdef DEBUG
+				heapstat_steady_set(0);
+			#endif
+			game_state_leave();
+			game_state_enter(!game_state);
+			if(game_state == GS_GAME) {
+				night_current++;
 			}
 		    space_pressed = 1;
 			assets_print_loaded();
+			#ifdef DEBUG
+				heapstat_steady_set(1);
+			#endif
 		}
 		
-		if(glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_RELEASE) {
+		if(!platform_key_down(GLFW_KEY_SPACE)) {
 		    space_pressed = 0;
 		}
 
-		mouse_get_position(window, mouse_position);
+		/* dump what's eating all the memory */
+		if(platform_key_down(GLFW_KEY_M) && !memstat_key_pressed) {
+			memstat_print_groups();
+			memstat_print_top(10);
+			memstat_key_pressed = 1;
+		}
+
+		if(!platform_key_down(GLFW_KEY_M)) {
+			memstat_key_pressed = 0;
+		}
+
+		if(platform_key_down(GLFW_KEY_L) && !latency_key_pressed) {
+			sound_latency_print();
+			latency_key_pressed = 1;
+		}
+
+		if(!platform_key_down(GLFW_KEY_L)) {
+			latency_key_pressed = 0;
+		}
+
+		if(platform_key_down(GLFW_KEY_H) && !frametime_key_pressed) {
+			frametime_print();
+			frametime_key_pressed = 1;
+		}
+
+		if(!platform_key_down(GLFW_KEY_H)) {
+			frametime_key_pressed = 0;
+		}
+
+		if(platform_key_down(GLFW_KEY_F3) && !hud_key_pressed) {
+			hud_toggle();
+			hud_key_pressed = 1;
+		}
+
+		if(!platform_key_down(GLFW_KEY_F3)) {
+			hud_key_pressed = 0;
+		}
+
+		#ifdef PROFILE
+		if(platform_key_down(GLFW_KEY_P) && !profile_key_pressed) {
+			profile_print();
+			callstat_print();
+			profile_key_pressed = 1;
+		}
+
+		if(!platform_key_down(GLFW_KEY_P)) {
+			profile_key_pressed = 0;
+		}
+		#endif
+
+		platform_mouse_position(mouse_position);
+		PROFILE_END(PROFILE_INPUT);
 
 		/* update all animations */
+		PROFILE_BEGIN(PROFILE_UPDATE);
 		fan_animation_frame += ticks;
 		fan_animation_frame = fmod2(fan_animation_frame, 3);
 
@@ -389,7 +605,10 @@ int main() {
 			}
 			static_animation_alpha = 1.0f - ((((game_state == GS_TITLE) ? 100.0f : 150.0f) + (rand() % 50) + static_animation_rand_value) / 255.0f);
 
-			sound_set_gain(assets_game.light_sound, light_buzz_volume_new);
+			/* the game assets aren't even loaded on the title screen */
+			if(game_state == GS_GAME) {
+				sound_set_gain(assets_game.light_sound, light_buzz_volume_new);
+			}
 			scaled_update_timer = 0.0f;
 
 			/* title glitchy blip flicker */
@@ -407,9 +626,13 @@ int main() {
 		}
 
 		glm_mat4_identity(matrix_view);
+		PROFILE_END(PROFILE_UPDATE);
+
 		switch(game_state) {
 			case GS_TITLE: {
 				const uint16_t glitchy_blip_frame = (uint16_t)(blink_timer_get_tick((float)time_now, 10.0f, 60.0f, 8.0f));
+				PROFILE_BEGIN(PROFILE_TITLE_DRAW);
+				PROFILE_GPU_BEGIN(PROFILE_TITLE_DRAW);
 
 				/* updating */
 				assets_title.scanline_sprite.position[1] = fmod2((float)time_now * 30.0f, 752.0f) - 32.0f;
@@ -488,8 +711,12 @@ int main() {
 					sprite_draw(assets_title.glitchy_blip, sprite_shader_program, glitchy_blip_frame);
 					glUniform1f(glGetUniformLocation(sprite_shader_program, "alpha"), 1.0f);
 				}
+				PROFILE_GPU_END(PROFILE_TITLE_DRAW);
+				PROFILE_END(PROFILE_TITLE_DRAW);
 
-				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				PROFILE_BEGIN(PROFILE_POST);
+				PROFILE_GPU_BEGIN(PROFILE_POST);
+				glBindFramebuffer(GL_FRAMEBUFFER, platform_framebuffer());
 				glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 				glClear(GL_COLOR_BUFFER_BIT);
 
@@ -507,7 +734,11 @@ int main() {
 
 				glBindVertexArray(render_vao);
 				glDrawArrays(GL_TRIANGLES, 0, 6);
+				PROFILE_GPU_END(PROFILE_POST);
+				PROFILE_END(PROFILE_POST);
 
+				PROFILE_BEGIN(PROFILE_UI);
+				PROFILE_GPU_BEGIN(PROFILE_UI);
 				#ifdef DEBUG
 				{
 					char buffers[10][256];
@@ -524,8 +755,14 @@ int main() {
 
 					for(uint8_t i = 0; i < 10; i++)
 						font_draw(assets_global.debug_font, buffers[i], (vec2){WINDOW_WIDTH - 64.0f, WINDOW_HEIGHT + 256.0f - (48.0f * i)}, GLM_VEC3_ONE, 0.6f);
+
+					#ifdef PROFILE
+						debug_callstat_draw(WINDOW_WIDTH - 64.0f, WINDOW_HEIGHT + 256.0f - (48.0f * 10));
+					#endif
 				}
 				#endif
+				PROFILE_GPU_END(PROFILE_UI);
+				PROFILE_END(PROFILE_UI);
 
 				break;
 			}
@@ -544,6 +781,8 @@ int main() {
 					{1186.0f, 568.0f},
 					{1195.0f, 437.0f},
 				};
+				PROFILE_BEGIN(PROFILE_GAME_DRAW);
+				PROFILE_GPU_BEGIN(PROFILE_GAME_DRAW);
 
 				/* use the appropriate room scroll setting */
 				if(camera_state != CS_OPENED) {
@@ -575,6 +814,7 @@ int main() {
 							switch(camera_state) {
 								case CS_CLOSED:
 									camera_state = CS_OPENING;
+									camera_feed_request(&assets_game.camera_feed, camera_selected_offsets[camera_selected] + (camera_selected == 3));
 									sound_stop(assets_game.camera_close_sound);
 									sound_play(assets_game.camera_open_sound);
 									sound_play(assets_game.camera_scan_sound);
@@ -608,6 +848,10 @@ int main() {
 						}
 					}
 
+					if(camera_state != camera_state_old) {
+						trace_instant(camera_state_names[camera_state], "state");
+					}
+
 					if(camera_state == CS_OPENED && camera_state_old != CS_OPENED) {
 						door_button_flags &= DOOR_BUTTON_BOTH_DOORS_FLAG;
 						sound_play(assets_global.blip_sound);
@@ -640,7 +884,7 @@ int main() {
 				}
 
 				/* check for clicking door buttons */
-				if(glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_1) == GLFW_PRESS && !mouse_has_clicked) {
+				if(platform_mouse_down(GLFW_MOUSE_BUTTON_1) && !mouse_has_clicked) {
 					const uint8_t door_button_flags_old = door_button_flags;
 					const int32_t mouse_offset = (int32_t)office_look_current;
 
@@ -682,6 +926,7 @@ int main() {
 								sound_play(assets_global.blip_sound);
 								blip_animation_frame = 0;
 								camera_selected = i;
+								camera_feed_request(&assets_game.camera_feed, camera_selected_offsets[camera_selected] + (camera_selected == 3));
 							}
 						}
 					}
@@ -711,10 +956,12 @@ int main() {
 
 				power_left_value -= ((float)power_usage_value + 1.0f) * time_delta * 0.1f;
 
-				if(glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_1) == GLFW_RELEASE) {
+				if(!platform_mouse_down(GLFW_MOUSE_BUTTON_1)) {
 					mouse_has_clicked = 0;
 				}
 
+				camera_feed_update(&assets_game.camera_feed);
+
 				glm_translate(matrix_view, (vec3){(camera_state == CS_OPENED) ? camera_look_current : office_look_current, 0.0f, 0.0f});
 
 				/* draw */
@@ -742,13 +989,17 @@ int main() {
 						sprite_draw(assets_game.door_button_sprites[i], sprite_shader_program, (door_button_flags >> (2 * i)) & 0x3);
 					}
 				} else {
-					const uint8_t camera_selected_offsets[11] = { 0, 7, 13, 18, 54, 60, 62, 68, 77, 0, 81 };
+					camera_feed_missing = 0;
 					if(camera_selected != 9) {
-						sprite_draw(assets_game.camera_view_sprite, sprite_shader_program, camera_selected_offsets[camera_selected] + ((light_flicker <= 3) * camera_selected == 3));
+						camera_feed_missing = !camera_feed_draw(&assets_game.camera_feed, sprite_shader_program, camera_selected_offsets[camera_selected] + ((light_flicker <= 3) * camera_selected == 3));
 					}
 				}
+				PROFILE_GPU_END(PROFILE_GAME_DRAW);
+				PROFILE_END(PROFILE_GAME_DRAW);
 
-				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				PROFILE_BEGIN(PROFILE_POST);
+				PROFILE_GPU_BEGIN(PROFILE_POST);
+				glBindFramebuffer(GL_FRAMEBUFFER, platform_framebuffer());
 				glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 				glClear(GL_COLOR_BUFFER_BIT);
 
@@ -760,8 +1011,12 @@ int main() {
 				glBindTexture(GL_TEXTURE_2D, render_texture);
 				glBindVertexArray(render_vao);
 				glDrawArrays(GL_TRIANGLES, 0, 6);
+				PROFILE_GPU_END(PROFILE_POST);
+				PROFILE_END(PROFILE_POST);
 
 				/* ui elements */
+				PROFILE_BEGIN(PROFILE_UI);
+				PROFILE_GPU_BEGIN(PROFILE_UI);
 				glUseProgram(ui_shader_program);
 				glUniformMatrix4fv(glGetUniformLocation(ui_shader_program, "projection"), 1, GL_FALSE, (const GLfloat *)matrix_projection);
 				glUniform1f(glGetUniformLocation(ui_shader_program, "alpha"), 1.0f);
@@ -777,7 +1032,8 @@ int main() {
 					blink_state_dot = blink_timer_dot < 0.5f;
 					blink_state_buttons = blink_timer_buttons < 0.5f;
 
-					glUniform1f(glGetUniformLocation(ui_shader_program, "alpha"), static_animation_alpha);
+					/* full static hides a feed that's still loading */
+					glUniform1f(glGetUniformLocation(ui_shader_program, "alpha"), camera_feed_missing ? 1.0f : static_animation_alpha);
 					sprite_draw(assets_global.static_animation_sprite, ui_shader_program, static_animation_frame);
 					glUniform1f(glGetUniformLocation(ui_shader_program, "alpha"), 1.0f);
 
@@ -826,7 +1082,7 @@ int main() {
 				if(hour_timer >= 6.0f) {
 					/* TODO: Eventually add code to advance the night */
 					printf("Congratulations! You survived to 6 AM!\n");
-					glfwSetWindowShouldClose(window, 1);
+					platform_close();
 				}
 
 				if(hour_timer < 1.0f) {
@@ -871,28 +1127,78 @@ int main() {
 					for(uint8_t i = 0; i < 9; i++) {
 						font_draw(assets_global.debug_font, buffers[i], (vec2){64.0f, WINDOW_HEIGHT + 256.0f - (48.0f * i)}, GLM_VEC3_ONE, 0.6f);
 					}
+
+					#ifdef PROFILE
+						debug_callstat_draw(64.0f, WINDOW_HEIGHT + 256.0f - (48.0f * 9));
+					#endif
 				}
 				#endif
+				PROFILE_GPU_END(PROFILE_UI);
+				PROFILE_END(PROFILE_UI);
 
 				break;
 			}
 		}
 
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+		/* on top of everything, outside the pass scopes so it only shows up in the whole frame */
+		hud_draw((const float *)matrix_projection);
+
+		/* everything the frame asked the audio to do goes out in one go */
+		sound_flush();
+
+		PROFILE_BEGIN(PROFILE_SWAP);
+		platform_present();
+		PROFILE_END(PROFILE_SWAP);
+
+		PROFILE_END(PROFILE_FRAME);
+		PROFILE_FRAME_END();
+		if(benchmark_active()) {
+			benchmark_frame_end();
+		}
+		frametime_frame(game_state_names[game_state], (game_state == GS_GAME) ? camera_state_names[camera_state] : "none");
+		trace_frame();
+
+		/* only the first frame counts */
+		startup_phase("first frame");
+		startup_finish(startup_report_path);
+
+		#ifdef DEBUG
+			heapstat_frame_check();
+		#endif
 	}
 
+	#ifdef DEBUG
+		sound_latency_print();
+	#endif
+	sound_loopback_print();
+	benchmark_print();
+	frametime_print();
+
 	/* destroy everything */
 	glDeleteFramebuffers(1, &fbo);
 	assets_game_destroy(&assets_game);
 	assets_title_destroy(&assets_title);
 	assets_global_destroy(&assets_global);
+	cache_destroy();
+	assets_manifest_destroy();
+	job_system_destroy();
+	benchmark_destroy();
+	PROFILE_DESTROY();
+	upload_system_destroy();
 	sound_system_destroy();
+	memstat_destroy();
+	trace_destroy();
+	frametime_destroy();
 
+	hud_destroy();
 	glDeleteShader(sprite_shader_program);
 	glDeleteShader(ui_shader_program);
 	glDeleteShader(render_shader_program);
 
-	glfwTerminate();
+	platform_destroy();
+
+	#ifdef DEBUG
+		heapstat_print("LEAKED");
+	#endif
 	return 0;
 }
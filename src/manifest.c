@@ -0,0 +1,147 @@
+#include "manifest.h"
+#include "memstat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heapstat.h"
+
+#define MANIFEST_LINE_LENGTH_MAX	512
+
+static const char *group_names[MEMSTAT_GROUP_COUNT] = {"global", "title", "game"};
+static const char *kind_names[MANIFEST_KIND_COUNT] = {"sprite", "feed", "sound", "stream", "font"};
+
+static uint8_t manifest_lookup(const char *name, const char **names, const uint8_t count) {
+	for(uint8_t i = 0; i < count; i++) {
+		if(!strcmp(name, names[i]))
+			return i;
+	}
+
+	return count;
+}
+
+static uint8_t manifest_entry_parse(manifest_entry_t *entry, const char *line) {
+	char group_name[16];
+	char kind_name[16];
+	int32_t read;
+	int32_t parsed;
+
+	memset(entry, 0, sizeof(manifest_entry_t));
+	if(sscanf(line, "%15s %15s %63s%n", group_name, kind_name, entry->name, &read) != 3)
+		return 0;
+
+	entry->group = manifest_lookup(group_name, group_names, MEMSTAT_GROUP_COUNT);
+	entry->kind = manifest_lookup(kind_name, kind_names, MANIFEST_KIND_COUNT);
+	if(entry->group == MEMSTAT_GROUP_COUNT || entry->kind == MANIFEST_KIND_COUNT)
+		return 0;
+
+	line += read;
+	switch(entry->kind) {
+		case MANIFEST_SPRITE:
+		case MANIFEST_FEED:
+			parsed = sscanf(line, "%f %f %f %f %hu %255s", &entry->position[0], &entry->position[1], &entry->size[0], &entry->size[1], &entry->frame_count, entry->path);
+			return parsed == 6 && entry->frame_count > 0;
+
+		case MANIFEST_SOUND:
+			parsed = sscanf(line, "%f %f %hhu %hhu %255s", &entry->pitch, &entry->gain, &entry->loop, &entry->priority, entry->path);
+			entry->frame_count = 1;
+			return parsed == 5;
+
+		case MANIFEST_STREAM:
+			parsed = sscanf(line, "%f %f %hhu %255s", &entry->pitch, &entry->gain, &entry->loop, entry->path);
+			entry->frame_count = 1;
+			return parsed == 4;
+
+		case MANIFEST_FONT:
+			parsed = sscanf(line, "%255s", entry->path);
+			entry->frame_count = 1;
+			return parsed == 1;
+	}
+
+	return 0;
+}
+
+manifest_t manifest_load(const char *path) {
+	manifest_t manifest = {NULL, 0};
+	uint32_t entry_capacity = 0;
+	uint32_t line_number = 0;
+	char line[MANIFEST_LINE_LENGTH_MAX];
+	FILE *file;
+
+	file = fopen(path, "r");
+	if(!file) {
+		printf("ERROR: Manifest at '%s' fucked up.\n", path);
+		return manifest;
+	}
+
+	while(fgets(line, MANIFEST_LINE_LENGTH_MAX, file)) {
+		const char *c = line;
+		line_number++;
+
+		while(*c == ' ' || *c == '\t')
+			c++;
+
+		if(*c == '#' || *c == '\n' || *c == '\r' || !*c)
+			continue;
+
+		if(manifest.entry_count == entry_capacity) {
+			entry_capacity = entry_capacity ? entry_capacity * 2 : 64;
+			manifest.entries = realloc(manifest.entries, entry_capacity * sizeof(manifest_entry_t));
+		}
+
+		if(!manifest_entry_parse(&manifest.entries[manifest.entry_count], c)) {
+			printf("ERROR: Manifest line %u fucked up: %s", line_number, line);
+			fclose(file);
+			manifest_destroy(&manifest);
+			return manifest;
+		}
+
+		manifest.entry_count++;
+	}
+
+	fclose(file);
+	return manifest;
+}
+
+uint32_t manifest_validate(const manifest_t manifest) {
+	uint32_t missing = 0;
+	char path[SPRITE_PATH_LENGTH_MAX];
+
+	for(uint32_t i = 0; i < manifest.entry_count; i++) {
+		const manifest_entry_t *entry = &manifest.entries[i];
+		for(uint16_t j = 0; j < entry->frame_count; j++) {
+			FILE *file;
+
+			sprite_texture_path(entry->path, entry->frame_count, j, path);
+			file = fopen(path, "rb");
+			if(!file) {
+				printf("ERROR: '%s' (%s %s) is missing.\n", path, group_names[entry->group], entry->name);
+				missing++;
+				continue;
+			}
+			fclose(file);
+		}
+	}
+
+	return missing;
+}
+
+const manifest_entry_t *manifest_find(const manifest_t manifest, const uint8_t group, const char *name) {
+	for(uint32_t i = 0; i < manifest.entry_count; i++) {
+		if(manifest.entries[i].group == group && !strcmp(manifest.entries[i].name, name))
+			return &manifest.entries[i];
+	}
+
+	return NULL;
+}
+
+const char *manifest_kind_name(const uint8_t kind) {
+	return kind_names[kind];
+}
+
+void manifest_destroy(manifest_t *manifest) {
+	free(manifest->entries);
+	manifest->entries = NULL;
+	manifest->entry_count = 0;
+}
@@ -0,0 +1,165 @@
+#include "memstat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heapstat.h"
+
+typedef struct {
+	char owner[MEMSTAT_OWNER_LENGTH_MAX];
+	uint64_t size;
+	uint32_t handle;
+	uint8_t kind;
+	uint8_t group;
+} memstat_record_t;
+
+typedef struct {
+	const char *owner;
+	uint64_t size;
+	uint8_t group;
+} memstat_owner_total_t;
+
+static memstat_record_t *records = NULL;
+static uint32_t record_count = 0;
+static uint32_t record_capacity = 0;
+
+static uint8_t group_current = MEMSTAT_GROUP_GLOBAL;
+static char owner_current[MEMSTAT_OWNER_LENGTH_MAX] = "unknown";
+
+static const char *group_names[MEMSTAT_GROUP_COUNT] = {"GLOBAL", "TITLE", "GAME"};
+
+/* heapstat reads the group from worker threads too */
+void memstat_group_set(const uint8_t group) {
+	__atomic_store_n(&group_current, group, __ATOMIC_RELAXED);
+}
+
+uint8_t memstat_group_get(void) {
+	return __atomic_load_n(&group_current, __ATOMIC_RELAXED);
+}
+
+void memstat_owner_set(const char *owner) {
+	snprintf(owner_current, MEMSTAT_OWNER_LENGTH_MAX, "%s", owner);
+}
+
+const char *memstat_owner_get(void) {
+	return owner_current;
+}
+
+void memstat_record(const uint8_t kind, const uint8_t group, const char *owner, const uint32_t handle, const uint64_t size) {
+	memstat_record_t *record;
+
+	if(record_count == record_capacity) {
+		record_capacity = record_capacity ? record_capacity * 2 : 256;
+		records = realloc(records, record_capacity * sizeof(memstat_record_t));
+	}
+
+	record = &records[record_count++];
+	snprintf(record->owner, MEMSTAT_OWNER_LENGTH_MAX, "%s", owner);
+	record->size = size;
+	record->handle = handle;
+	record->kind = kind;
+	record->group = group;
+}
+
+void memstat_release(const uint8_t kind, const uint32_t handle) {
+	for(uint32_t i = 0; i < record_count; i++) {
+		if(records[i].kind != kind || records[i].handle != handle)
+			continue;
+
+		records[i] = records[--record_count];
+		return;
+	}
+}
+
+uint64_t memstat_group_total(const uint8_t group) {
+	uint64_t total = 0;
+	for(uint32_t i = 0; i < record_count; i++) {
+		total += records[i].size * (records[i].group == group);
+	}
+
+	return total;
+}
+
+uint64_t memstat_kind_total(const uint8_t kind) {
+	uint64_t total = 0;
+	for(uint32_t i = 0; i < record_count; i++) {
+		total += records[i].size * (records[i].kind == kind);
+	}
+
+	return total;
+}
+
+uint64_t memstat_total(void) {
+	uint64_t total = 0;
+	for(uint32_t i = 0; i < record_count; i++) {
+		total += records[i].size;
+	}
+
+	return total;
+}
+
+void memstat_print_groups(void) {
+	uint64_t totals[MEMSTAT_GROUP_COUNT][MEMSTAT_KIND_COUNT] = {{0}};
+
+	for(uint32_t i = 0; i < record_count; i++) {
+		totals[records[i].group][records[i].kind] += records[i].size;
+	}
+
+	printf("%-8s %13s %13s %13s %13s\n", "GROUP", "TEXTURES", "GLYPHS", "AUDIO", "TOTAL");
+	for(uint8_t i = 0; i < MEMSTAT_GROUP_COUNT; i++) {
+		const uint64_t total = totals[i][MEMSTAT_TEXTURE] + totals[i][MEMSTAT_GLYPH] + totals[i][MEMSTAT_AUDIO];
+		printf("%-8s %9.2f MiB %9.2f MiB %9.2f MiB %9.2f MiB\n", group_names[i],
+				(double)totals[i][MEMSTAT_TEXTURE] / 1048576.0,
+				(double)totals[i][MEMSTAT_GLYPH] / 1048576.0,
+				(double)totals[i][MEMSTAT_AUDIO] / 1048576.0,
+				(double)total / 1048576.0);
+	}
+}
+
+static int memstat_owner_total_compare(const void *a, const void *b) {
+	const memstat_owner_total_t *owner_a = a;
+	const memstat_owner_total_t *owner_b = b;
+	return (owner_a->size < owner_b->size) - (owner_a->size > owner_b->size);
+}
+
+void memstat_print_top(const uint8_t count) {
+	memstat_owner_total_t *owners;
+	uint32_t owner_count = 0;
+
+	if(!record_count)
+		return;
+
+	/* add up every record per owner */
+	owners = calloc(record_count, sizeof(memstat_owner_total_t));
+	for(uint32_t i = 0; i < record_count; i++) {
+		uint32_t j;
+		for(j = 0; j < owner_count; j++) {
+			if(owners[j].group == records[i].group && !strcmp(owners[j].owner, records[i].owner))
+				break;
+		}
+
+		if(j == owner_count) {
+			owners[owner_count].owner = records[i].owner;
+			owners[owner_count].group = records[i].group;
+			owner_count++;
+		}
+		owners[j].size += records[i].size;
+	}
+
+	qsort(owners, owner_count, sizeof(memstat_owner_total_t), memstat_owner_total_compare);
+
+	printf("TOP %u OF %u OWNERS (%.2f MiB TOTAL)\n", count, owner_count, (double)memstat_total() / 1048576.0);
+	for(uint32_t i = 0; i < owner_count && i < count; i++) {
+		printf("    %9.2f MiB  %-8s %s\n", (double)owners[i].size / 1048576.0, group_names[owners[i].group], owners[i].owner);
+	}
+
+	free(owners);
+}
+
+void memstat_destroy(void) {
+	free(records);
+	records = NULL;
+	record_count = 0;
+	record_capacity = 0;
+}
@@ -0,0 +1,264 @@
+#include "platform.h"
+#include "startup.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#define PLATFORM_HEADLESS_FRAMETIME		(1.0 / 60.0)
+
+static uint8_t platform_kind = PLATFORM_WINDOW;
+static uint8_t platform_closing = 0;
+
+static GLFWwindow *window = NULL;
+
+static EGLDisplay egl_display = EGL_NO_DISPLAY;
+static EGLContext egl_context = EGL_NO_CONTEXT;
+static EGLSurface egl_surface = EGL_NO_SURFACE;
+static uint32_t headless_framebuffer = 0;
+static uint32_t headless_color = 0;
+static uint64_t headless_frames = 0;
+static ivec2 headless_mouse = {0, 0};
+
+static uint8_t platform_window_create(const int32_t width, const int32_t height, const char *title) {
+	GLFWmonitor *monitor;
+	ivec2 monitor_size;
+	int32_t monitor_count;
+
+	#ifdef DEBUG
+		if(!glfwInit()) {
+			printf("ERROR: GLFW fucked up.\n");
+			return 0;
+		}
+	#else
+		glfwInit();
+	#endif
+	startup_phase("glfw init");
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, 1);
+
+	window = glfwCreateWindow(width, height, title, NULL, NULL);
+	#ifdef DEBUG
+		if(!window) {
+			printf("ERROR: Window fucked up.\n");
+			glfwTerminate();
+			return 0;
+		}
+	#endif
+
+	/* center it on the first monitor */
+	monitor = *glfwGetMonitors(&monitor_count);
+	#ifdef DEBUG
+		if(!monitor) {
+			printf("ERROR: Monitor fucked up.\n");
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return 0;
+		}
+	#endif
+
+	glfwGetMonitorWorkarea(monitor, NULL, NULL, &monitor_size[0], &monitor_size[1]);
+	glfwSetWindowPos(window, (monitor_size[0] / 2) - (width / 2), (monitor_size[1] / 2) - (height / 2));
+	glfwMakeContextCurrent(window);
+	startup_phase("window");
+
+	#ifdef DEBUG
+		if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+			printf("ERROR: GLAD fucked up.\n");
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return 0;
+		}
+	#else
+		gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+	#endif
+	startup_phase("glad");
+
+	return 1;
+}
+
+/* Mesa's surfaceless platform needs no display server, anything else gets the default display and a pbuffer */
+static EGLDisplay platform_egl_display(void) {
+	const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+	if(extensions && strstr(extensions, "EGL_MESA_platform_surfaceless") && get_platform_display) {
+		EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+		if(display != EGL_NO_DISPLAY)
+			return display;
+	}
+
+	return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+static uint8_t platform_headless_create(const int32_t width, const int32_t height) {
+	const EGLint config_attributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	const EGLint context_attributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	const EGLint surface_attributes[] = {EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE};
+	EGLConfig config = NULL;
+	EGLint config_count = 0;
+
+	egl_display = platform_egl_display();
+	if(egl_display == EGL_NO_DISPLAY || !eglInitialize(egl_display, NULL, NULL)) {
+		printf("ERROR: Couldn't get an EGL display to render headless with.\n");
+		return 0;
+	}
+	startup_phase("egl init");
+
+	eglBindAPI(EGL_OPENGL_API);
+	eglChooseConfig(egl_display, config_attributes, &config, 1, &config_count);
+
+	/* surfaceless displays don't always hand out configs, and don't need one */
+	egl_context = eglCreateContext(egl_display, config_count ? config : NULL, EGL_NO_CONTEXT, context_attributes);
+	if(egl_context == EGL_NO_CONTEXT) {
+		printf("ERROR: Couldn't create a GL 3.3 core context through EGL (0x%x).\n", eglGetError());
+		eglTerminate(egl_display);
+		return 0;
+	}
+
+	if(!strstr(eglQueryString(egl_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context") && config_count) {
+		egl_surface = eglCreatePbufferSurface(egl_display, config, surface_attributes);
+	}
+
+	if(!eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context)) {
+		printf("ERROR: Couldn't make the EGL context current (0x%x).\n", eglGetError());
+		eglDestroyContext(egl_display, egl_context);
+		eglTerminate(egl_display);
+		return 0;
+	}
+	startup_phase("context");
+
+	if(!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+		printf("ERROR: GLAD fucked up.\n");
+		return 0;
+	}
+	startup_phase("glad");
+
+	/* stands in for the window's framebuffer */
+	glGenRenderbuffers(1, &headless_color);
+	glBindRenderbuffer(GL_RENDERBUFFER, headless_color);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenFramebuffers(1, &headless_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, headless_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, headless_color);
+	if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		printf("ERROR: Headless framebuffer fucked up.\n");
+		return 0;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	printf("HEADLESS on %s\n", (const char *)glGetString(GL_RENDERER));
+	return 1;
+}
+
+uint8_t platform_create(const uint8_t kind, const int32_t width, const int32_t height, const char *title) {
+	platform_kind = kind;
+	platform_closing = 0;
+
+	if(kind == PLATFORM_HEADLESS)
+		return platform_headless_create(width, height);
+
+	return platform_window_create(width, height, title);
+}
+
+void platform_destroy(void) {
+	if(platform_kind == PLATFORM_WINDOW) {
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		window = NULL;
+		return;
+	}
+
+	glDeleteFramebuffers(1, &headless_framebuffer);
+	glDeleteRenderbuffers(1, &headless_color);
+	eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if(egl_surface != EGL_NO_SURFACE) {
+		eglDestroySurface(egl_display, egl_surface);
+	}
+	eglDestroyContext(egl_display, egl_context);
+	eglTerminate(egl_display);
+	egl_display = EGL_NO_DISPLAY;
+	egl_context = EGL_NO_CONTEXT;
+	egl_surface = EGL_NO_SURFACE;
+}
+
+uint8_t platform_should_close(void) {
+	if(platform_kind == PLATFORM_WINDOW && glfwWindowShouldClose(window))
+		return 1;
+
+	return platform_closing;
+}
+
+void platform_close(void) {
+	platform_closing = 1;
+}
+
+double platform_time(void) {
+	if(platform_kind == PLATFORM_HEADLESS)
+		return (double)headless_frames * PLATFORM_HEADLESS_FRAMETIME;
+
+	return glfwGetTime();
+}
+
+uint32_t platform_framebuffer(void) {
+	return headless_framebuffer;
+}
+
+void platform_present(void) {
+	if(platform_kind == PLATFORM_HEADLESS) {
+		glFlush();
+		headless_frames++;
+		return;
+	}
+
+	glfwSwapBuffers(window);
+	glfwPollEvents();
+}
+
+uint8_t platform_key_down(const int32_t key) {
+	if(platform_kind == PLATFORM_HEADLESS)
+		return 0;
+
+	return glfwGetKey(window, key) == GLFW_PRESS;
+}
+
+uint8_t platform_mouse_down(const int32_t button) {
+	if(platform_kind == PLATFORM_HEADLESS)
+		return 0;
+
+	return glfwGetMouseButton(window, button) == GLFW_PRESS;
+}
+
+void platform_mouse_position(ivec2 output) {
+	double x, y;
+
+	if(platform_kind == PLATFORM_HEADLESS) {
+		glm_ivec2_copy(headless_mouse, output);
+		return;
+	}
+
+	glfwGetCursorPos(window, &x, &y);
+	output[0] = (int32_t)x;
+	output[1] = (int32_t)y;
+}
+
+void platform_mouse_set(const int32_t x, const int32_t y) {
+	headless_mouse[0] = x;
+	headless_mouse[1] = y;
+}
@@ -0,0 +1,199 @@
+#include "profile.h"
+
+#ifdef PROFILE
+
+#include "timer.h"
+#include "trace.h"
+#include "callstat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glad/glad.h>
+
+typedef struct {
+	uint64_t samples[PROFILE_HISTORY_LENGTH];
+	uint16_t next;
+	uint16_t count;
+} profile_history_t;
+
+/* llvmpipe hands back a raw timestamp for the very first query, nothing real takes a whole second */
+#define PROFILE_GPU_SAMPLE_MAX_NS	1000000000ULL
+
+typedef struct {
+	profile_history_t cpu;
+	profile_history_t gpu;
+	uint64_t started;
+	uint64_t frame_total;
+	uint64_t cpu_last;
+	uint64_t gpu_last;
+	uint32_t queries[PROFILE_GPU_LATENCY];
+	uint8_t query_issued[PROFILE_GPU_LATENCY];
+	uint8_t ran;
+} profile_scope_t;
+
+static const char *scope_names[PROFILE_SCOPE_COUNT] = {
+	"frame", "input", "update", "title draw", "game draw", "post-process", "ui", "swap",
+};
+
+static profile_scope_t scopes[PROFILE_SCOPE_COUNT];
+static uint32_t frame_index = 0;
+
+/* the scope whose GL_TIME_ELAPSED query is running, PROFILE_SCOPE_COUNT when there isn't one */
+static uint8_t gpu_scope_active = PROFILE_SCOPE_COUNT;
+
+static void profile_history_add(profile_history_t *history, const uint64_t sample) {
+	history->samples[history->next] = sample;
+	history->next = (history->next + 1) % PROFILE_HISTORY_LENGTH;
+	if(history->count < PROFILE_HISTORY_LENGTH) {
+		history->count++;
+	}
+}
+
+void profile_create(void) {
+	for(uint8_t i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+		glGenQueries(PROFILE_GPU_LATENCY, scopes[i].queries);
+	}
+}
+
+void profile_destroy(void) {
+	for(uint8_t i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+		glDeleteQueries(PROFILE_GPU_LATENCY, scopes[i].queries);
+	}
+}
+
+void profile_begin(const uint8_t scope) {
+	scopes[scope].started = timer_now_ns();
+	trace_begin(scope_names[scope], "scope");
+}
+
+void profile_end(const uint8_t scope) {
+	scopes[scope].frame_total += timer_now_ns() - scopes[scope].started;
+	scopes[scope].ran = 1;
+	trace_end(scope_names[scope], "scope");
+}
+
+void profile_gpu_begin(const uint8_t scope) {
+	const uint8_t slot = frame_index % PROFILE_GPU_LATENCY;
+
+	/* one query per scope per frame, a second pass in the same frame just doesn't get timed */
+	if(scopes[scope].query_issued[slot] || gpu_scope_active != PROFILE_SCOPE_COUNT)
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, scopes[scope].queries[slot]);
+	scopes[scope].query_issued[slot] = 1;
+	gpu_scope_active = scope;
+}
+
+void profile_gpu_end(const uint8_t scope) {
+	/* only ends what this scope's begin actually started */
+	if(gpu_scope_active != scope)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	gpu_scope_active = PROFILE_SCOPE_COUNT;
+}
+
+void profile_frame_end(void) {
+	/* the slot next frame is going to reuse is the oldest, so it's had the longest to finish */
+	const uint8_t oldest = (frame_index + 1) % PROFILE_GPU_LATENCY;
+
+	for(uint8_t i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+		profile_scope_t *s = &scopes[i];
+
+		s->gpu_last = 0;
+		s->cpu_last = 0;
+		if(s->query_issued[oldest]) {
+			GLuint available = 0;
+			glGetQueryObjectuiv(s->queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+
+			/* still not back, so it gets dropped rather than waited on */
+			if(available) {
+				GLuint64 elapsed;
+				glGetQueryObjectui64v(s->queries[oldest], GL_QUERY_RESULT, &elapsed);
+				if(elapsed < PROFILE_GPU_SAMPLE_MAX_NS) {
+					profile_history_add(&s->gpu, (uint64_t)elapsed);
+					s->gpu_last = (uint64_t)elapsed;
+				}
+			}
+			s->query_issued[oldest] = 0;
+		}
+
+		if(!s->ran)
+			continue;
+
+		profile_history_add(&s->cpu, s->frame_total);
+		s->cpu_last = s->frame_total;
+		s->frame_total = 0;
+		s->ran = 0;
+	}
+
+	callstat_frame_end();
+	frame_index++;
+}
+
+static int profile_sample_compare(const void *a, const void *b) {
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+static profile_stats_t profile_history_stats(const profile_history_t *history) {
+	profile_stats_t stats = {0.0, 0.0, 0.0, 0.0, 0};
+	uint64_t sorted[PROFILE_HISTORY_LENGTH];
+	uint64_t total = 0;
+
+	if(!history->count)
+		return stats;
+
+	for(uint16_t i = 0; i < history->count; i++) {
+		sorted[i] = history->samples[i];
+		total += history->samples[i];
+	}
+	qsort(sorted, history->count, sizeof(uint64_t), profile_sample_compare);
+
+	stats.min = timer_ms(sorted[0]);
+	stats.avg = timer_ms(total / history->count);
+	stats.max = timer_ms(sorted[history->count - 1]);
+	stats.p99 = timer_ms(sorted[(history->count * 99) / 100]);
+	stats.sample_count = history->count;
+	return stats;
+}
+
+profile_stats_t profile_stats(const uint8_t scope) {
+	return profile_history_stats(&scopes[scope].cpu);
+}
+
+profile_stats_t profile_gpu_stats(const uint8_t scope) {
+	return profile_history_stats(&scopes[scope].gpu);
+}
+
+uint64_t profile_last(const uint8_t scope) {
+	return scopes[scope].cpu_last;
+}
+
+uint64_t profile_gpu_last(const uint8_t scope) {
+	return scopes[scope].gpu_last;
+}
+
+const char *profile_scope_name(const uint8_t scope) {
+	return scope_names[scope];
+}
+
+void profile_print(void) {
+	printf("%-14s %9s %9s %9s %9s %9s %9s\n", "SCOPE (ms)", "MIN", "AVG", "MAX", "P99", "GPU AVG", "GPU P99");
+	for(uint8_t i = 0; i < PROFILE_SCOPE_COUNT; i++) {
+		const profile_stats_t stats = profile_stats(i);
+		const profile_stats_t gpu_stats = profile_gpu_stats(i);
+		if(!stats.sample_count)
+			continue;
+
+		printf("%-14s %9.3f %9.3f %9.3f %9.3f", scope_names[i], stats.min, stats.avg, stats.max, stats.p99);
+		if(gpu_stats.sample_count) {
+			printf(" %9.3f %9.3f\n", gpu_stats.avg, gpu_stats.p99);
+		} else {
+			printf(" %9s %9s\n", "-", "-");
+		}
+	}
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <glad/glad.h>
 #include "file.h"
 
+#include "heapstat.h"
+
 shader_t shader_create(const char *shader_vertex_path, const char *shader_fragment_path) {
 	const uint32_t shader_types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
 	const char *shader_paths[2] = {shader_vertex_path, shader_fragment_path};
@@ -25,6 +27,7 @@ shader_t shader_create(const char *shader_vertex_path, const char *shader_fragme
 		#ifdef DEBUG
 			if(!shader_sources[i]) {
 				printf("ERROR: %s shader loading fucked up.\n", shader_type_names[i]);
+				glDeleteProgram(shader_program);
 				return 0;
 			}
 		#endif
@@ -37,7 +40,10 @@ shader_t shader_create(const char *shader_vertex_path, const char *shader_fragme
 			glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
 			if(!success) {
 				glGetShaderInfoLog(shaders[i], 512, NULL, info_log);
-				printf("ERROR: Vertex shader fucked up: %s\n", info_log);
+				printf("ERROR: %s shader fucked up: %s\n", shader_type_names[i], info_log);
+				glDeleteShader(shaders[i]);
+				glDeleteProgram(shader_program);
+				free(shader_sources[i]);
 				return 0;
 			}
 		#endif
@@ -1,21 +1,98 @@
 #include "sound.h"
+#include "memstat.h"
+#include "cache.h"
+#include "sound_stream.h"
+#include "sound_pool.h"
+#include "sound_thread.h"
+#include "sound_loopback.h"
+#include "timer.h"
 
 #include <stdlib.h>
 #include <AL/al.h>
 #include <AL/alc.h>
+#include <AL/alext.h>
 #include <sndfile.h>
 #include <limits.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/stat.h>
 
 #include <assert.h>
 
+#include "callstat.h"
+#include "heapstat.h"
+
 static ALCdevice *sound_device;
 static ALCcontext *sound_context;
+static uint32_t sound_id_next = 1;
+
+enum {
+	SOUND_COMMAND_NONE = 0,
+	SOUND_COMMAND_PLAY,
+	SOUND_COMMAND_STOP
+};
+
+/* One per sound that's been touched, what it should do at the next flush and the last gain AL was given */
+typedef struct {
+	sound_t sound;
+	uint64_t requested;
+	float gain;
+	float gain_applied;
+	uint8_t action;
+	uint8_t restart;
+	uint8_t used;
+} sound_command_t;
+
+/* A buffer AL reads in place through AL_EXT_STATIC_BUFFER, and the mapping it reads from */
+typedef struct {
+	file_mapping_t mapping;
+	sound_buffer_t buffer;
+} sound_static_buffer_t;
+
+/* The parts of a RIFF chunk header we look at */
+typedef struct {
+	char id[4];
+	uint32_t size;
+} sound_wav_chunk_t;
+
+static sound_command_t sound_commands[SOUND_COMMAND_SLOT_MAX];
+static sound_static_buffer_t sound_static_buffers[SOUND_STATIC_BUFFER_MAX];
+static LPALBUFFERDATASTATIC al_buffer_data_static = NULL;
+
+/* What every buffer gets resampled to, so the mixer doesn't have to. 0 until there's a device */
+static int32_t sound_device_frequency = 0;
+
+#define SOUND_PCM_CACHE_MAGIC		0x4d435046 /* "FPCM" */
+#define SOUND_PCM_CACHE_VERSION		1
+
+/* Followed by "data_size" bytes of interleaved int16 samples */
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t source_size;
+	int64_t source_modified;
+	uint64_t data_size;
+	int32_t sample_rate;
+	int32_t channels;
+} sound_pcm_header_t;
 
-void sound_system_create() {
+uint8_t sound_system_create(const sound_config_t config) {
+	int32_t attributes[15];
+	uint8_t attribute_count = 0;
 	#ifdef DEBUG
 		const char *sound_device_name;
+		int32_t refresh, mono_sources, stereo_sources;
 	#endif
-	sound_device = alcOpenDevice(NULL);
+
+	if(config.loopback_frequency) {
+		sound_device = sound_loopback_open(config.loopback_frequency);
+		if(!sound_device)
+			return 0;
+
+		attribute_count = sound_loopback_attributes(attributes, attribute_count);
+	} else {
+		sound_device = alcOpenDevice(NULL);
+	}
 	#ifdef DEBUG
 		if(!sound_device) {
 		    printf("ERROR: Audio Device fucked up.");
@@ -23,7 +100,26 @@ void sound_system_create() {
 		}
 	#endif
 	
-	sound_context = alcCreateContext(sound_device, NULL);
+	/* the loopback render format already decides the frequency */
+	if(config.frequency && !config.loopback_frequency) {
+		attributes[attribute_count++] = ALC_FREQUENCY;
+		attributes[attribute_count++] = config.frequency;
+	}
+	if(config.refresh) {
+		attributes[attribute_count++] = ALC_REFRESH;
+		attributes[attribute_count++] = config.refresh;
+	}
+	if(config.mono_sources) {
+		attributes[attribute_count++] = ALC_MONO_SOURCES;
+		attributes[attribute_count++] = config.mono_sources;
+	}
+	if(config.stereo_sources) {
+		attributes[attribute_count++] = ALC_STEREO_SOURCES;
+		attributes[attribute_count++] = config.stereo_sources;
+	}
+	attributes[attribute_count] = 0;
+
+	sound_context = alcCreateContext(sound_device, attributes);
 	#ifdef DEBUG
 		if(!sound_context) {
 		    printf("ERROR: Audio Context fucked up.");
@@ -51,27 +147,163 @@ void sound_system_create() {
 		}
 		printf("SOUND DEVICE: %s\n", sound_device_name);
 	#endif
+
+	/* what we asked for is only a hint, this is what we actually got */
+	alcGetIntegerv(sound_device, ALC_FREQUENCY, 1, &sound_device_frequency);
+	#ifdef DEBUG
+		alcGetIntegerv(sound_device, ALC_REFRESH, 1, &refresh);
+		alcGetIntegerv(sound_device, ALC_MONO_SOURCES, 1, &mono_sources);
+		alcGetIntegerv(sound_device, ALC_STEREO_SOURCES, 1, &stereo_sources);
+		printf("SOUND CONTEXT: %d Hz, %d updates/s, %d mono sources, %d stereo sources\n", sound_device_frequency, refresh, mono_sources, stereo_sources);
+	#endif
+
+	if(alIsExtensionPresent("AL_EXT_STATIC_BUFFER")) {
+		al_buffer_data_static = (LPALBUFFERDATASTATIC)alGetProcAddress("alBufferDataStatic");
+	}
+
+	sound_pool_create();
+	sound_thread_create();
+	return 1;
 }
 
 void sound_system_destroy() {
+	sound_thread_destroy();
+	sound_pool_destroy();
 	alcDestroyContext(sound_context);
 	alcCloseDevice(sound_device);
+	sound_loopback_close();
 }
 
-sound_buffer_t sound_buffer_create(const char *path) {
-	sound_buffer_t sound_buffer;
+static void sound_buffer_delete(uint32_t sound_buffer) {
+	memstat_release(MEMSTAT_AUDIO, sound_buffer);
+	alDeleteBuffers(1, &sound_buffer);
+
+	/* static buffers read straight out of the mapping, so it can only go once AL is done with it */
+	for(uint8_t i = 0; i < SOUND_STATIC_BUFFER_MAX; i++) {
+		if(sound_static_buffers[i].buffer == sound_buffer) {
+			file_unmap(&sound_static_buffers[i].mapping);
+			sound_static_buffers[i].buffer = 0;
+		}
+	}
+}
+
+static void sound_pcm_cache_path(const char *path, char *output, const size_t output_size) {
+	size_t length;
+
+	snprintf(output, output_size, "%s%s.pcm", SOUND_PCM_CACHE_DIRECTORY, path);
+	length = strlen(SOUND_PCM_CACHE_DIRECTORY);
+	for(char *c = output + length; *c; c++) {
+		if(*c == '/' || *c == '\\') {
+			*c = '_';
+		}
+	}
+}
+
+static uint8_t sound_pcm_cache_load(const char *path, sound_pcm_t *pcm) {
+	char cache_path[PATH_MAX];
+	struct stat source_stat;
+	sound_pcm_header_t header;
+	file_mapping_t mapping;
+
+	if(stat(path, &source_stat))
+		return 0;
+
+	sound_pcm_cache_path(path, cache_path, sizeof(cache_path));
+	mapping = file_map(cache_path);
+	if(!mapping.data)
+		return 0;
+
+	if(mapping.size < sizeof(header)) {
+		file_unmap(&mapping);
+		return 0;
+	}
+
+	/* anything stale or from another device rate gets rebuilt */
+	memcpy(&header, mapping.data, sizeof(header));
+	if(header.magic != SOUND_PCM_CACHE_MAGIC ||
+			header.version != SOUND_PCM_CACHE_VERSION ||
+			header.source_size != (uint64_t)source_stat.st_size ||
+			header.source_modified != (int64_t)source_stat.st_mtime ||
+			header.data_size != mapping.size - sizeof(header) ||
+			header.channels < 1 || header.channels > 2 ||
+			(sound_device_frequency && header.sample_rate != sound_device_frequency)) {
+		file_unmap(&mapping);
+		return 0;
+	}
+
+	pcm->mapping = mapping;
+	pcm->samples = (int16_t *)((uint8_t *)mapping.data + sizeof(header));
+	pcm->size = header.data_size;
+	pcm->format = header.channels == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+	pcm->sample_rate = header.sample_rate;
+	return 1;
+}
+
+static void sound_pcm_cache_store(const char *path, const sound_pcm_t pcm) {
+	char cache_path[PATH_MAX];
+	char temporary_path[PATH_MAX + 4];
+	struct stat source_stat;
+	sound_pcm_header_t header;
+	FILE *file;
+	uint8_t written;
+
+	if(stat(path, &source_stat))
+		return;
+
+	header.magic = SOUND_PCM_CACHE_MAGIC;
+	header.version = SOUND_PCM_CACHE_VERSION;
+	header.source_size = (uint64_t)source_stat.st_size;
+	header.source_modified = (int64_t)source_stat.st_mtime;
+	header.data_size = pcm.size;
+	header.sample_rate = pcm.sample_rate;
+	header.channels = pcm.format == AL_FORMAT_STEREO16 ? 2 : 1;
+
+	/* written to the side and renamed, so nobody ever maps half a file */
+	mkdir(SOUND_PCM_CACHE_DIRECTORY, 0755);
+	sound_pcm_cache_path(path, cache_path, sizeof(cache_path));
+	snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", cache_path);
+	file = fopen(temporary_path, "wb");
+	if(!file)
+		return;
+
+	written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(pcm.samples, pcm.size, 1, file) == 1;
+	written = !fclose(file) && written;
+	if(!written || rename(temporary_path, cache_path)) {
+		#ifdef DEBUG
+			printf("ERROR: PCM cache writing fucked up: %s\n", cache_path);
+		#endif
+		remove(temporary_path);
+	}
+}
+
+/* Linear, which is plenty for sound effects */
+static int16_t *sound_pcm_resample(const int16_t *samples, const uint64_t frame_count, const int32_t channels, const int32_t from, const int32_t to, uint64_t *output_frame_count) {
+	const uint64_t output_frames = frame_count * (uint64_t)to / (uint64_t)from;
+	const double step = (double)from / (double)to;
+	int16_t *output = malloc(output_frames * (uint64_t)channels * sizeof(int16_t));
+
+	for(uint64_t i = 0; i < output_frames; i++) {
+		const double position = (double)i * step;
+		const uint64_t frame = (uint64_t)position;
+		const uint64_t next = frame + 1 < frame_count ? frame + 1 : frame;
+		const float t = (float)(position - (double)frame);
+
+		for(int32_t c = 0; c < channels; c++) {
+			const float a = samples[frame * (uint64_t)channels + (uint64_t)c];
+			const float b = samples[next * (uint64_t)channels + (uint64_t)c];
+			output[i * (uint64_t)channels + (uint64_t)c] = (int16_t)(a + (b - a) * t);
+		}
+	}
+
+	*output_frame_count = output_frames;
+	return output;
+}
+
+static sound_pcm_t sound_pcm_decode(const char *path) {
+	sound_pcm_t pcm = {{NULL, 0}, NULL, 0, AL_NONE, 0};
 	SNDFILE *file;
 	SF_INFO file_info;
 	uint64_t frame_count;
-	int32_t format = AL_NONE;
-	int16_t *buffer;
-	uint64_t size;
-
-	/*
-	#ifdef DEBUG
-		int32_t error;
-	#endif
-	*/
 
 	int32_t formats[2] = {
 		AL_FORMAT_MONO16,
@@ -79,7 +311,6 @@ sound_buffer_t sound_buffer_create(const char *path) {
 	};
 
 	file = sf_open(path, SFM_READ, &file_info);
-	format = formats[file_info.channels - 1];
 	#ifdef DEBUG
 		if(!file) {
 			printf("ERROR: Sound loading fucked up: %s", path);
@@ -92,42 +323,181 @@ sound_buffer_t sound_buffer_create(const char *path) {
 			assert(0);
 		}
 
-		if((format != AL_FORMAT_MONO16) && (format != AL_FORMAT_STEREO16)) {
+		if(file_info.channels < 1 || file_info.channels > 2) {
 			sf_close(file);
-			printf("ERROR: Format fucked up at path '%s': %u\n", path, format);
+			printf("ERROR: Format fucked up at path '%s': %d channels\n", path, file_info.channels);
 			assert(0);
 		}
 	#endif
+	if(!file)
+		return pcm;
 
-	buffer = malloc((uint64_t)(file_info.frames * file_info.channels) * sizeof(int16_t));
-	frame_count = (uint64_t)sf_readf_short(file, buffer, file_info.frames);
+	pcm.format = formats[file_info.channels - 1];
+	pcm.sample_rate = file_info.samplerate;
+	pcm.samples = malloc((uint64_t)(file_info.frames * file_info.channels) * sizeof(int16_t));
+	frame_count = (uint64_t)sf_readf_short(file, pcm.samples, file_info.frames);
 	#ifdef DEBUG
 		if(frame_count < 1) {
-			free(buffer);
+			free(pcm.samples);
 			sf_close(file);
 			printf("ERROR: Sample reading fucked up.");
 			assert(0);
 		}
 	#endif
 
-	size = frame_count * (uint64_t)file_info.channels * sizeof(int16_t);
+	sf_close(file);
 
-	sound_buffer = 0;
-	alGenBuffers(1, &sound_buffer);
-	alBufferData(sound_buffer, format, (void *)buffer, (int32_t)size, file_info.samplerate);
+	if(sound_device_frequency && sound_device_frequency != file_info.samplerate) {
+		int16_t *resampled = sound_pcm_resample(pcm.samples, frame_count, file_info.channels, file_info.samplerate, sound_device_frequency, &frame_count);
+		free(pcm.samples);
+		pcm.samples = resampled;
+		pcm.sample_rate = sound_device_frequency;
+	}
 
-	/*
-	#ifdef DEBUG
-		error = alGetError();
-		free(buffer);
-		sf_close(file);
+	pcm.size = frame_count * (uint64_t)file_info.channels * sizeof(int16_t);
+	return pcm;
+}
 
-		if(error) {
-			printf("ERROR: Buffers fucked up at path '%s': %s\n", path, alGetString(error));
-			assert(0);
+/* Plain PCM16 WAVs already are what AL wants, so the data chunk gets used right where it's mapped */
+static uint8_t sound_pcm_wav_map(const char *path, sound_pcm_t *pcm) {
+	file_mapping_t mapping;
+	const uint8_t *data, *end;
+	uint16_t format_tag = 0, channels = 0, bits = 0;
+	uint32_t sample_rate = 0;
+	uint8_t format_found = 0;
+
+	mapping = file_map(path);
+	if(!mapping.data)
+		return 0;
+
+	data = mapping.data;
+	end = data + mapping.size;
+	if(mapping.size < 12 || memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4)) {
+		file_unmap(&mapping);
+		return 0;
+	}
+
+	for(data += 12; data + sizeof(sound_wav_chunk_t) <= end;) {
+		sound_wav_chunk_t chunk;
+		const uint8_t *body = data + sizeof(sound_wav_chunk_t);
+
+		memcpy(&chunk, data, sizeof(chunk));
+		if(chunk.size > (uint64_t)(end - body))
+			break;
+
+		if(!memcmp(chunk.id, "fmt ", 4) && chunk.size >= 16) {
+			memcpy(&format_tag, body, sizeof(format_tag));
+			memcpy(&channels, body + 2, sizeof(channels));
+			memcpy(&sample_rate, body + 4, sizeof(sample_rate));
+			memcpy(&bits, body + 14, sizeof(bits));
+
+			/* WAVE_FORMAT_EXTENSIBLE keeps the real format at the start of the subformat GUID */
+			if(format_tag == 0xFFFE && chunk.size >= 26) {
+				memcpy(&format_tag, body + 24, sizeof(format_tag));
+			}
+			format_found = 1;
+		} else if(!memcmp(chunk.id, "data", 4)) {
+			/* anything that would need converting or resampling goes the slow way */
+			if(!format_found || format_tag != 1 || bits != 16 || channels < 1 || channels > 2 || !chunk.size ||
+					(sound_device_frequency && (int32_t)sample_rate != sound_device_frequency))
+				break;
+
+			pcm->mapping = mapping;
+			pcm->samples = (int16_t *)body;
+			pcm->size = chunk.size - chunk.size % (channels * sizeof(int16_t));
+			pcm->format = channels == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+			pcm->sample_rate = (int32_t)sample_rate;
+			return 1;
 		}
-	#endif
-	*/
+
+		/* chunks are padded out to an even size */
+		data = body + chunk.size + (chunk.size & 1);
+	}
+
+	file_unmap(&mapping);
+	return 0;
+}
+
+sound_pcm_t sound_pcm_load(const char *path) {
+	sound_pcm_t pcm = {{NULL, 0}, NULL, 0, AL_NONE, 0};
+
+	if(sound_pcm_wav_map(path, &pcm))
+		return pcm;
+
+	if(sound_pcm_cache_load(path, &pcm))
+		return pcm;
+
+	pcm = sound_pcm_decode(path);
+	if(pcm.samples && pcm.size) {
+		sound_pcm_cache_store(path, pcm);
+	}
+
+	return pcm;
+}
+
+void sound_pcm_free(sound_pcm_t *pcm) {
+	if(pcm->mapping.data) {
+		file_unmap(&pcm->mapping);
+	} else {
+		free(pcm->samples);
+	}
+	pcm->samples = NULL;
+	pcm->size = 0;
+}
+
+sound_buffer_t sound_buffer_find(const char *path) {
+	return cache_acquire(CACHE_SOUND_BUFFER, path, 0);
+}
+
+sound_buffer_t sound_buffer_create_shared(const char *path, sound_pcm_t *pcm) {
+	sound_buffer_t sound_buffer = 0;
+	sound_static_buffer_t *static_buffer = NULL;
+
+	alGenBuffers(1, &sound_buffer);
+
+	/* mapped samples can be read by AL in place, if it knows how */
+	for(uint8_t i = 0; al_buffer_data_static && pcm->mapping.data && i < SOUND_STATIC_BUFFER_MAX; i++) {
+		if(!sound_static_buffers[i].buffer) {
+			static_buffer = &sound_static_buffers[i];
+			break;
+		}
+	}
+
+	if(static_buffer) {
+		al_buffer_data_static((int32_t)sound_buffer, pcm->format, pcm->samples, (int32_t)pcm->size, pcm->sample_rate);
+		static_buffer->buffer = sound_buffer;
+		static_buffer->mapping = pcm->mapping;
+
+		/* the buffer owns the mapping now */
+		pcm->mapping.data = NULL;
+		pcm->mapping.size = 0;
+		pcm->samples = NULL;
+	} else {
+		alBufferData(sound_buffer, pcm->format, (void *)pcm->samples, (int32_t)pcm->size, pcm->sample_rate);
+	}
+
+	memstat_record(MEMSTAT_AUDIO, memstat_group_get(), path, sound_buffer, pcm->size);
+	cache_insert(CACHE_SOUND_BUFFER, path, 0, sound_buffer, pcm->size, sound_buffer_delete);
+
+	return sound_buffer;
+}
+
+sound_buffer_t sound_buffer_create(const char *path) {
+	sound_buffer_t sound_buffer;
+	sound_pcm_t pcm;
+
+	sound_buffer = sound_buffer_find(path);
+	if(sound_buffer)
+		return sound_buffer;
+
+	pcm = sound_pcm_load(path);
+	if(!pcm.samples)
+		return 0;
+
+	sound_buffer = sound_buffer_create_shared(path, &pcm);
+
+	/* AL has its own copy now, or holds on to the mapping itself */
+	sound_pcm_free(&pcm);
 
 	return sound_buffer;
 }
@@ -144,26 +514,178 @@ sound_source_t sound_source_create(sound_buffer_t sound_buffer, const float pitc
 	return sound_source;
 }
 
-sound_t sound_create(const char *path, const float pitch, const float gain, const float *position, const uint8_t loop) {
+static sound_t sound_init(const char *path, const float pitch, const float gain, const float *position, const uint8_t priority) {
 	sound_t sound;
+	sound.path = path;
+	sound.buffer = 0;
+	sound.source = 0;
+	sound.stream = NULL;
+	sound.position[0] = position[0];
+	sound.position[1] = position[1];
+	sound.position[2] = position[2];
+	sound.pitch = pitch;
+	sound.gain = gain;
+	sound.id = sound_id_next++;
+	sound.priority = priority;
+	return sound;
+}
+
+sound_t sound_create(const char *path, const float pitch, const float gain, const float *position, const uint8_t loop, const uint8_t priority) {
+	sound_t sound = sound_init(path, pitch, gain, position, priority);
 	sound.buffer = sound_buffer_create(path);
-	sound.source = sound_source_create(sound.buffer, pitch, gain, position, loop);
+	if(loop) {
+		sound.source = sound_source_create(sound.buffer, pitch, gain, position, loop);
+	}
 	return sound;
 }
 
+sound_t sound_stream_create(const char *path, const float pitch, const float gain, const float *position, const uint8_t loop) {
+	sound_t sound = sound_init(path, pitch, gain, position, 0);
+	sound.source = sound_source_create(0, pitch, gain, position, 0);
+	sound.stream = sound_stream_open(path, sound.source, loop);
+	return sound;
+}
+
+static void sound_command_push(const sound_t sound, const uint8_t type, const uint64_t time, const uint64_t requested, const float gain) {
+	sound_thread_command_t command;
+	command.sound = sound;
+	command.time = time;
+	command.requested = requested;
+	command.gain = gain;
+	command.type = type;
+	sound_thread_push(command);
+}
+
+/* Sounds that overflow the table just skip the batching */
+static sound_command_t *sound_command_get(const sound_t sound) {
+	sound_command_t *free_command = NULL;
+
+	for(uint8_t i = 0; i < SOUND_COMMAND_SLOT_MAX; i++) {
+		if(sound_commands[i].used && sound_commands[i].sound.id == sound.id)
+			return &sound_commands[i];
+
+		if(!sound_commands[i].used && !free_command) {
+			free_command = &sound_commands[i];
+		}
+	}
+
+	#ifdef DEBUG
+		if(!free_command) {
+			printf("ERROR: Sound command buffer fucked up, more than %d sounds.\n", SOUND_COMMAND_SLOT_MAX);
+		}
+	#endif
+	if(!free_command)
+		return NULL;
+
+	free_command->sound = sound;
+	free_command->requested = 0;
+	free_command->gain = sound.gain;
+	free_command->gain_applied = sound.gain;
+	free_command->action = SOUND_COMMAND_NONE;
+	free_command->restart = 0;
+	free_command->used = 1;
+	return free_command;
+}
+
 void sound_set_gain(const sound_t sound, const float gain) {
-	alSourcef(sound.source, AL_GAIN, gain);
+	sound_command_t *command = sound_command_get(sound);
+	if(!command) {
+		sound_command_push(sound, SOUND_THREAD_GAIN, timer_now_ns(), 0, gain);
+		return;
+	}
+
+	command->gain = gain;
 }
 
 void sound_play(const sound_t sound) {
-	alSourcePlay(sound.source);
+	sound_command_t *command = sound_command_get(sound);
+	if(!command) {
+		const uint64_t now = timer_now_ns();
+		sound_command_push(sound, SOUND_THREAD_PLAY, now, now, sound.gain);
+		return;
+	}
+
+	/* a play restarts the sound anyway, the stop only matters for pooled voices still ringing out */
+	command->restart = command->action == SOUND_COMMAND_STOP;
+	command->action = SOUND_COMMAND_PLAY;
+	command->requested = timer_now_ns();
 }
 
 void sound_stop(const sound_t sound) {
-	alSourceStop(sound.source);
+	sound_command_t *command = sound_command_get(sound);
+	if(!command) {
+		sound_command_push(sound, SOUND_THREAD_STOP, timer_now_ns(), 0, 0.0f);
+		return;
+	}
+
+	command->restart = 0;
+	command->action = SOUND_COMMAND_STOP;
+}
+
+void sound_flush(void) {
+	/* one timestamp for the whole frame, so whatever got triggered together starts together */
+	const uint64_t now = timer_now_ns();
+
+	for(uint8_t i = 0; i < SOUND_COMMAND_SLOT_MAX; i++) {
+		sound_command_t *command = &sound_commands[i];
+		if(!command->used)
+			continue;
+
+		if(command->gain != command->gain_applied) {
+			sound_command_push(command->sound, SOUND_THREAD_GAIN, now, 0, command->gain);
+			command->gain_applied = command->gain;
+		}
+
+		switch(command->action) {
+			case SOUND_COMMAND_PLAY:
+				if(command->restart && !command->sound.source) {
+					sound_command_push(command->sound, SOUND_THREAD_STOP, now, 0, 0.0f);
+				}
+				if(sound_loopback_active()) {
+					sound_loopback_log(command->sound.path);
+				}
+				sound_command_push(command->sound, SOUND_THREAD_PLAY, now, command->requested, command->gain);
+				break;
+
+			case SOUND_COMMAND_STOP:
+				sound_command_push(command->sound, SOUND_THREAD_STOP, now, 0, 0.0f);
+				break;
+		}
+
+		command->action = SOUND_COMMAND_NONE;
+		command->restart = 0;
+	}
+}
+
+void sound_buffer_destroy(sound_buffer_t *sound_buffer) {
+	if(!*sound_buffer)
+		return;
+
+	if(!cache_release(CACHE_SOUND_BUFFER, *sound_buffer)) {
+		sound_buffer_delete(*sound_buffer);
+	}
+	*sound_buffer = 0;
 }
 
 void sound_destroy(sound_t *sound) {
-	alDeleteSources(1, &sound->source);
-	alDeleteBuffers(1, &sound->buffer);
+	/* the audio thread has to be done with its source, voices and buffer first */
+	sound_command_push(*sound, SOUND_THREAD_RELEASE, timer_now_ns(), 0, 0.0f);
+	sound_thread_wait();
+
+	if(sound->stream) {
+		sound_stream_close(sound->stream);
+		sound->stream = NULL;
+	}
+
+	if(sound->source) {
+		alDeleteSources(1, &sound->source);
+	}
+	sound_buffer_destroy(&sound->buffer);
+
+	/* anything still queued for it would touch a dead source */
+	for(uint8_t i = 0; i < SOUND_COMMAND_SLOT_MAX; i++) {
+		if(sound_commands[i].used && sound_commands[i].sound.id == sound->id) {
+			sound_commands[i].used = 0;
+		}
+	}
 }
@@ -0,0 +1,145 @@
+#include "sound_latency.h"
+#include "timer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <AL/al.h>
+
+#include "callstat.h"
+
+/* Give up on anything that hasn't started after this long, it got stolen or stopped */
+#define SOUND_LATENCY_TIMEOUT_NS		1000000000
+
+/* sounds get a new id every time their state reloads, the path stays the same */
+typedef struct {
+	const char *path;
+	uint64_t playing_total;
+	uint64_t advance_total;
+	uint64_t advance_min;
+	uint64_t advance_max;
+	uint32_t count;
+	uint32_t late;
+	uint32_t missed;
+} sound_latency_stat_t;
+
+typedef struct {
+	uint64_t played;
+	uint64_t playing;
+	sound_source_t source;
+	uint32_t id;
+	sound_latency_stat_t *stat;
+} sound_latency_pending_t;
+
+static sound_latency_pending_t pending[SOUND_LATENCY_PENDING_MAX];
+static sound_latency_stat_t stats[SOUND_LATENCY_SOUND_MAX];
+static uint8_t stat_count = 0;
+static pthread_mutex_t latency_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* adds it if there's room, NULL if there isn't */
+static sound_latency_stat_t *sound_latency_stat_get(const char *path) {
+	sound_latency_stat_t *stat;
+
+	for(uint8_t i = 0; i < stat_count; i++) {
+		if(!strcmp(stats[i].path, path))
+			return &stats[i];
+	}
+
+	if(stat_count >= SOUND_LATENCY_SOUND_MAX)
+		return NULL;
+
+	stat = &stats[stat_count++];
+	stat->path = path;
+	stat->advance_min = UINT64_MAX;
+	return stat;
+}
+
+void sound_latency_trigger(const sound_t sound, const sound_source_t source, const uint64_t requested) {
+	sound_latency_pending_t *slot = NULL;
+	sound_latency_stat_t *stat;
+
+	if(!source)
+		return;
+
+	pthread_mutex_lock(&latency_mutex);
+	stat = sound_latency_stat_get(sound.path);
+
+	/* a source that gets restarted only counts its latest play */
+	for(uint8_t i = 0; i < SOUND_LATENCY_PENDING_MAX; i++) {
+		if(pending[i].source == source || (!slot && !pending[i].source)) {
+			slot = &pending[i];
+		}
+	}
+
+	if(slot) {
+		slot->played = requested;
+		slot->playing = 0;
+		slot->source = source;
+		slot->id = sound.id;
+		slot->stat = stat;
+	}
+	pthread_mutex_unlock(&latency_mutex);
+}
+
+void sound_latency_poll(void) {
+	const uint64_t now = timer_now_ns();
+
+	pthread_mutex_lock(&latency_mutex);
+	for(uint8_t i = 0; i < SOUND_LATENCY_PENDING_MAX; i++) {
+		sound_latency_pending_t *trigger = &pending[i];
+		sound_latency_stat_t *stat;
+		int32_t state, offset;
+		uint64_t advance;
+
+		if(!trigger->source)
+			continue;
+
+		stat = trigger->stat;
+		alGetSourcei(trigger->source, AL_SOURCE_STATE, &state);
+		alGetSourcei(trigger->source, AL_SAMPLE_OFFSET, &offset);
+		if(state == AL_PLAYING && !trigger->playing) {
+			trigger->playing = now;
+		}
+
+		if(trigger->playing && offset > 0) {
+			advance = now - trigger->played;
+			if(stat) {
+				stat->playing_total += trigger->playing - trigger->played;
+				stat->advance_total += advance;
+				if(advance < stat->advance_min) {
+					stat->advance_min = advance;
+				}
+				if(advance > stat->advance_max) {
+					stat->advance_max = advance;
+				}
+
+				stat->late += advance > SOUND_LATENCY_FRAME_NS;
+				stat->count++;
+			}
+			trigger->source = 0;
+		} else if(now - trigger->played > SOUND_LATENCY_TIMEOUT_NS) {
+			if(stat) {
+				stat->missed++;
+			}
+			trigger->source = 0;
+		}
+	}
+	pthread_mutex_unlock(&latency_mutex);
+}
+
+void sound_latency_print(void) {
+	pthread_mutex_lock(&latency_mutex);
+	printf("%-48s %6s %13s %13s %13s %13s %5s %6s\n", "SOUND", "PLAYS", "PLAYING AVG", "ADVANCE MIN", "ADVANCE AVG", "ADVANCE MAX", "LATE", "MISSED");
+	for(uint8_t i = 0; i < stat_count; i++) {
+		const sound_latency_stat_t *stat = &stats[i];
+		if(!stat->count) {
+			printf("%-48s %6u %13s %13s %13s %13s %5u %6u\n", stat->path, 0, "-", "-", "-", "-", 0, stat->missed);
+			continue;
+		}
+
+		printf("%-48s %6u %10.2f ms %10.2f ms %10.2f ms %10.2f ms %5u %6u\n", stat->path, stat->count,
+			timer_ms(stat->playing_total / stat->count), timer_ms(stat->advance_min),
+			timer_ms(stat->advance_total / stat->count), timer_ms(stat->advance_max), stat->late, stat->missed);
+	}
+	pthread_mutex_unlock(&latency_mutex);
+}
@@ -0,0 +1,143 @@
+#include "sound_loopback.h"
+#include "timer.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <AL/alext.h>
+
+typedef struct {
+	const char *path;
+	uint64_t frame;
+} sound_loopback_play_t;
+
+static LPALCLOOPBACKOPENDEVICESOFT alc_loopback_open_device;
+static LPALCISRENDERFORMATSUPPORTEDSOFT alc_is_render_format_supported;
+static LPALCRENDERSAMPLESSOFT alc_render_samples;
+
+static ALCdevice *loopback_device = NULL;
+static int32_t loopback_frequency;
+static double loopback_seconds;
+
+static int16_t scratch[SOUND_LOOPBACK_BLOCK_FRAMES * SOUND_LOOPBACK_CHANNELS];
+
+static uint64_t rendered_frame_count;
+static uint64_t render_time;
+static uint64_t render_block_worst;
+static uint32_t render_block_count;
+static int16_t render_peak;
+
+static sound_loopback_play_t plays[SOUND_LOOPBACK_LOG_MAX];
+static uint32_t play_count;
+static uint32_t play_dropped;
+
+ALCdevice *sound_loopback_open(const int32_t frequency) {
+	if(!alcIsExtensionPresent(NULL, "ALC_SOFT_loopback")) {
+		printf("ERROR: ALC_SOFT_loopback isn't supported, can't run without a sound device.\n");
+		return NULL;
+	}
+
+	alc_loopback_open_device = (LPALCLOOPBACKOPENDEVICESOFT)alcGetProcAddress(NULL, "alcLoopbackOpenDeviceSOFT");
+	alc_is_render_format_supported = (LPALCISRENDERFORMATSUPPORTEDSOFT)alcGetProcAddress(NULL, "alcIsRenderFormatSupportedSOFT");
+	alc_render_samples = (LPALCRENDERSAMPLESSOFT)alcGetProcAddress(NULL, "alcRenderSamplesSOFT");
+
+	loopback_device = alc_loopback_open_device(NULL);
+	if(!loopback_device)
+		return NULL;
+
+	if(!alc_is_render_format_supported(loopback_device, frequency, ALC_STEREO_SOFT, ALC_SHORT_SOFT)) {
+		printf("ERROR: Loopback can't render 16-bit stereo at %d Hz.\n", frequency);
+		alcCloseDevice(loopback_device);
+		loopback_device = NULL;
+		return NULL;
+	}
+
+	loopback_frequency = frequency;
+	return loopback_device;
+}
+
+uint8_t sound_loopback_attributes(int32_t *attributes, uint8_t attribute_count) {
+	attributes[attribute_count++] = ALC_FORMAT_CHANNELS_SOFT;
+	attributes[attribute_count++] = ALC_STEREO_SOFT;
+	attributes[attribute_count++] = ALC_FORMAT_TYPE_SOFT;
+	attributes[attribute_count++] = ALC_SHORT_SOFT;
+	attributes[attribute_count++] = ALC_FREQUENCY;
+	attributes[attribute_count++] = loopback_frequency;
+	return attribute_count;
+}
+
+uint8_t sound_loopback_active(void) {
+	return loopback_device != NULL;
+}
+
+void sound_loopback_render(const double seconds) {
+	uint64_t target;
+
+	if(!loopback_device)
+		return;
+
+	/* keep the fractional frames around so the render never drifts from the game clock */
+	loopback_seconds += seconds;
+	target = (uint64_t)(loopback_seconds * loopback_frequency);
+	while(rendered_frame_count < target) {
+		uint64_t frames = target - rendered_frame_count;
+		const int16_t *output = scratch;
+		uint64_t start, elapsed;
+
+		if(frames > SOUND_LOOPBACK_BLOCK_FRAMES) {
+			frames = SOUND_LOOPBACK_BLOCK_FRAMES;
+		}
+
+		start = timer_now_ns();
+		alc_render_samples(loopback_device, scratch, (int32_t)frames);
+		elapsed = timer_now_ns() - start;
+
+		render_time += elapsed;
+		render_block_count++;
+		if(elapsed > render_block_worst) {
+			render_block_worst = elapsed;
+		}
+
+		for(uint64_t i = 0; i < frames * SOUND_LOOPBACK_CHANNELS; i++) {
+			const int16_t level = output[i] < 0 ? (int16_t)-(output[i] + 1) : output[i];
+			if(level > render_peak) {
+				render_peak = level;
+			}
+		}
+
+		rendered_frame_count += frames;
+	}
+}
+
+void sound_loopback_log(const char *path) {
+	if(play_count == SOUND_LOOPBACK_LOG_MAX) {
+		play_dropped++;
+		return;
+	}
+
+	plays[play_count].path = path;
+	plays[play_count].frame = rendered_frame_count;
+	play_count++;
+}
+
+void sound_loopback_print(void) {
+	const double seconds = (double)rendered_frame_count / loopback_frequency;
+
+	if(!loopback_device)
+		return;
+
+	printf("LOOPBACK PLAYS:\n");
+	for(uint32_t i = 0; i < play_count; i++) {
+		printf("    %9.3f s  %s\n", (double)plays[i].frame / loopback_frequency, plays[i].path);
+	}
+	if(play_dropped) {
+		printf("    (%u more not logged)\n", play_dropped);
+	}
+
+	printf("LOOPBACK MIXER: %.2f s at %d Hz in %.2f ms (%.3f%% of real time), %u blocks, worst %.3f ms, peak %.1f dBFS\n",
+		seconds, loopback_frequency, timer_ms(render_time), seconds > 0.0 ? timer_ms(render_time) / (seconds * 10.0) : 0.0,
+		render_block_count, timer_ms(render_block_worst), render_peak ? 20.0 * log10((double)render_peak / 32767.0) : -INFINITY);
+}
+
+void sound_loopback_close(void) {
+	loopback_device = NULL;
+}
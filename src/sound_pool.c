@@ -0,0 +1,114 @@
+#include "sound_pool.h"
+
+#include <AL/al.h>
+
+#include "callstat.h"
+
+typedef struct {
+	uint64_t started;
+	sound_source_t source;
+	uint32_t owner;
+	float gain;
+	uint8_t priority;
+} sound_voice_t;
+
+static sound_voice_t voices[SOUND_POOL_VOICE_COUNT];
+static uint64_t voice_play_count = 0;
+
+void sound_pool_create(void) {
+	for(uint8_t i = 0; i < SOUND_POOL_VOICE_COUNT; i++) {
+		alGenSources(1, &voices[i].source);
+		alSource3f(voices[i].source, AL_VELOCITY, 0.0f, 0.0f, 0.0f);
+		alSourcei(voices[i].source, AL_LOOPING, AL_FALSE);
+		voices[i].started = 0;
+		voices[i].owner = 0;
+		voices[i].gain = 0.0f;
+		voices[i].priority = 0;
+	}
+}
+
+void sound_pool_destroy(void) {
+	for(uint8_t i = 0; i < SOUND_POOL_VOICE_COUNT; i++) {
+		alSourceStop(voices[i].source);
+		alDeleteSources(1, &voices[i].source);
+	}
+}
+
+/* A voice that's been handed out but not started yet sits rewound in AL_INITIAL, and counts as busy too */
+static uint8_t sound_voice_playing(const sound_voice_t *voice) {
+	int32_t state;
+	alGetSourcei(voice->source, AL_SOURCE_STATE, &state);
+	return state == AL_PLAYING || (state == AL_INITIAL && voice->owner);
+}
+
+/* Returns SOUND_POOL_VOICE_COUNT if everything playing is more important than "priority" */
+static uint8_t sound_voice_pick(const uint8_t priority) {
+	uint8_t victim = SOUND_POOL_VOICE_COUNT;
+
+	for(uint8_t i = 0; i < SOUND_POOL_VOICE_COUNT; i++) {
+		const sound_voice_t *voice = &voices[i];
+		const sound_voice_t *victim_voice = &voices[victim % SOUND_POOL_VOICE_COUNT];
+		if(!sound_voice_playing(voice))
+			return i;
+
+		if(voice->priority > priority)
+			continue;
+
+		if(victim == SOUND_POOL_VOICE_COUNT ||
+				voice->priority < victim_voice->priority ||
+				(voice->priority == victim_voice->priority && voice->gain < victim_voice->gain) ||
+				(voice->priority == victim_voice->priority && voice->gain == victim_voice->gain && voice->started < victim_voice->started)) {
+			victim = i;
+		}
+	}
+
+	return victim;
+}
+
+sound_source_t sound_pool_acquire(const sound_t sound, const float gain) {
+	const uint8_t index = sound_voice_pick(sound.priority);
+	sound_voice_t *voice;
+
+	if(index == SOUND_POOL_VOICE_COUNT)
+		return 0;
+
+	voice = &voices[index];
+	alSourceRewind(voice->source);
+	alSourcei(voice->source, AL_BUFFER, (int32_t)sound.buffer);
+	alSourcef(voice->source, AL_PITCH, sound.pitch);
+	alSourcef(voice->source, AL_GAIN, gain);
+	alSourcefv(voice->source, AL_POSITION, sound.position);
+
+	voice->started = ++voice_play_count;
+	voice->owner = sound.id;
+	voice->gain = gain;
+	voice->priority = sound.priority;
+	return voice->source;
+}
+
+void sound_pool_stop(const sound_t sound) {
+	for(uint8_t i = 0; i < SOUND_POOL_VOICE_COUNT; i++) {
+		if(voices[i].owner == sound.id) {
+			alSourceStop(voices[i].source);
+		}
+	}
+}
+
+void sound_pool_set_gain(const sound_t sound, const float gain) {
+	for(uint8_t i = 0; i < SOUND_POOL_VOICE_COUNT; i++) {
+		if(voices[i].owner == sound.id) {
+			alSourcef(voices[i].source, AL_GAIN, gain);
+			voices[i].gain = gain;
+		}
+	}
+}
+
+void sound_pool_release(const sound_t sound) {
+	for(uint8_t i = 0; i < SOUND_POOL_VOICE_COUNT; i++) {
+		if(voices[i].owner == sound.id) {
+			alSourceStop(voices[i].source);
+			alSourcei(voices[i].source, AL_BUFFER, 0);
+			voices[i].owner = 0;
+		}
+	}
+}
@@ -0,0 +1,279 @@
+#include "sound_stream.h"
+#include "memstat.h"
+#include "file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <AL/al.h>
+#include <sndfile.h>
+
+#include <assert.h>
+
+#include "callstat.h"
+#include "heapstat.h"
+
+struct sound_stream {
+	SNDFILE *file;
+	SF_INFO file_info;
+	uint8_t *encoded; /* compressed files are read out of memory instead of off the disk */
+	uint64_t encoded_size;
+	uint64_t encoded_position;
+	int16_t *chunk;
+	sound_buffer_t buffers[SOUND_STREAM_BUFFER_COUNT];
+	sound_source_t source;
+	int32_t format;
+	uint8_t loop;
+	uint8_t playing;
+};
+
+static sound_stream_t *streams[SOUND_STREAM_COUNT_MAX];
+static pthread_mutex_t stream_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Decodes the next chunk into "buffer", wrapping around for looping streams. Returns 0 at the end */
+static uint8_t sound_stream_fill(sound_stream_t *stream, const sound_buffer_t buffer) {
+	sf_count_t frames = 0;
+	uint8_t wrapped = 0;
+
+	while(frames < SOUND_STREAM_CHUNK_FRAMES) {
+		const sf_count_t frames_read = sf_readf_short(stream->file, stream->chunk + frames * stream->file_info.channels, SOUND_STREAM_CHUNK_FRAMES - frames);
+		frames += frames_read;
+		if(frames_read > 0) {
+			wrapped = 0;
+			continue;
+		}
+
+		/* wrapping straight into another end means the file's empty */
+		if(!stream->loop || wrapped || sf_seek(stream->file, 0, SEEK_SET) < 0)
+			break;
+		wrapped = 1;
+	}
+
+	if(!frames)
+		return 0;
+
+	alBufferData(buffer, stream->format, stream->chunk, (int32_t)(frames * stream->file_info.channels * (sf_count_t)sizeof(int16_t)), stream->file_info.samplerate);
+	return 1;
+}
+
+static void sound_stream_service(sound_stream_t *stream) {
+	int32_t processed = 0;
+	int32_t queued = 0;
+	int32_t state;
+
+	alGetSourcei(stream->source, AL_BUFFERS_PROCESSED, &processed);
+	while(processed-- > 0) {
+		sound_buffer_t buffer;
+		alSourceUnqueueBuffers(stream->source, 1, &buffer);
+		if(sound_stream_fill(stream, buffer)) {
+			alSourceQueueBuffers(stream->source, 1, &buffer);
+		}
+	}
+
+	/* we fell behind and the source ran dry, so kick it again */
+	alGetSourcei(stream->source, AL_BUFFERS_QUEUED, &queued);
+	alGetSourcei(stream->source, AL_SOURCE_STATE, &state);
+	if(state != AL_PLAYING) {
+		if(queued) {
+			alSourcePlay(stream->source);
+		} else {
+			stream->playing = 0;
+		}
+	}
+}
+
+void sound_stream_service_all(void) {
+	pthread_mutex_lock(&stream_mutex);
+	for(uint8_t i = 0; i < SOUND_STREAM_COUNT_MAX; i++) {
+		if(streams[i] && streams[i]->playing) {
+			sound_stream_service(streams[i]);
+		}
+	}
+	pthread_mutex_unlock(&stream_mutex);
+}
+
+static sf_count_t sound_stream_memory_length(void *user_data) {
+	const sound_stream_t *stream = user_data;
+	return (sf_count_t)stream->encoded_size;
+}
+
+static sf_count_t sound_stream_memory_seek(sf_count_t offset, int whence, void *user_data) {
+	sound_stream_t *stream = user_data;
+	sf_count_t position = offset;
+
+	if(whence == SEEK_CUR) {
+		position += (sf_count_t)stream->encoded_position;
+	} else if(whence == SEEK_END) {
+		position += (sf_count_t)stream->encoded_size;
+	}
+
+	if(position < 0 || position > (sf_count_t)stream->encoded_size)
+		return -1;
+
+	stream->encoded_position = (uint64_t)position;
+	return position;
+}
+
+static sf_count_t sound_stream_memory_read(void *output, sf_count_t count, void *user_data) {
+	sound_stream_t *stream = user_data;
+	const uint64_t left = stream->encoded_size - stream->encoded_position;
+
+	if((uint64_t)count > left) {
+		count = (sf_count_t)left;
+	}
+
+	memcpy(output, stream->encoded + stream->encoded_position, (size_t)count);
+	stream->encoded_position += (uint64_t)count;
+	return count;
+}
+
+static sf_count_t sound_stream_memory_write(const void *input, sf_count_t count, void *user_data) {
+	(void)input;
+	(void)count;
+	(void)user_data;
+	return 0;
+}
+
+static sf_count_t sound_stream_memory_tell(void *user_data) {
+	const sound_stream_t *stream = user_data;
+	return (sf_count_t)stream->encoded_position;
+}
+
+/* Only worth it when the file's a lot smaller than the PCM, otherwise it might as well stay on the disk */
+static uint8_t sound_stream_is_compressed(const SF_INFO file_info) {
+	const int32_t subtype = file_info.format & SF_FORMAT_SUBMASK;
+	return subtype == SF_FORMAT_VORBIS || subtype == SF_FORMAT_OPUS || (file_info.format & SF_FORMAT_TYPEMASK) == SF_FORMAT_FLAC;
+}
+
+static SNDFILE *sound_stream_open_memory(sound_stream_t *stream, const char *path) {
+	SF_VIRTUAL_IO io = {
+		sound_stream_memory_length,
+		sound_stream_memory_seek,
+		sound_stream_memory_read,
+		sound_stream_memory_write,
+		sound_stream_memory_tell,
+	};
+	SNDFILE *file;
+
+	stream->encoded = file_load_binary(path, &stream->encoded_size);
+	if(!stream->encoded)
+		return NULL;
+
+	stream->encoded_position = 0;
+	file = sf_open_virtual(&io, SFM_READ, &stream->file_info, stream);
+	if(!file) {
+		free(stream->encoded);
+		stream->encoded = NULL;
+		stream->encoded_size = 0;
+	}
+
+	return file;
+}
+
+sound_stream_t *sound_stream_open(const char *path, const sound_source_t source, const uint8_t loop) {
+	sound_stream_t *stream;
+	int32_t formats[2] = {
+		AL_FORMAT_MONO16,
+		AL_FORMAT_STEREO16,
+	};
+	uint8_t slot = SOUND_STREAM_COUNT_MAX;
+
+	/* only the main thread opens streams, so the slot is still free once the stream's ready for it */
+	pthread_mutex_lock(&stream_mutex);
+	for(uint8_t i = 0; i < SOUND_STREAM_COUNT_MAX; i++) {
+		if(!streams[i]) {
+			slot = i;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&stream_mutex);
+
+	/* one nothing services would just play silence */
+	if(slot == SOUND_STREAM_COUNT_MAX) {
+		#ifdef DEBUG
+			printf("ERROR: Sound streams fucked up, more than %d open: %s\n", SOUND_STREAM_COUNT_MAX, path);
+		#endif
+		return NULL;
+	}
+
+	stream = calloc(1, sizeof(sound_stream_t));
+	stream->file = sf_open(path, SFM_READ, &stream->file_info);
+	if(stream->file && sound_stream_is_compressed(stream->file_info)) {
+		SNDFILE *memory_file = sound_stream_open_memory(stream, path);
+		if(memory_file) {
+			sf_close(stream->file);
+			stream->file = memory_file;
+		}
+	}
+	#ifdef DEBUG
+		if(!stream->file || stream->file_info.channels < 1 || stream->file_info.channels > 2) {
+			printf("ERROR: Sound stream fucked up: %s\n", path);
+			assert(0);
+		}
+	#endif
+
+	stream->format = formats[stream->file_info.channels - 1];
+	stream->chunk = malloc(SOUND_STREAM_CHUNK_FRAMES * (uint64_t)stream->file_info.channels * sizeof(int16_t));
+	stream->source = source;
+	stream->loop = loop;
+	alGenBuffers(SOUND_STREAM_BUFFER_COUNT, stream->buffers);
+
+	/* the ring plus the decode scratch is all the PCM a stream ever holds, on top of the compressed file if it's in memory */
+	memstat_record(MEMSTAT_AUDIO, memstat_group_get(), path, stream->buffers[0], stream->encoded_size + (SOUND_STREAM_BUFFER_COUNT + 1) * SOUND_STREAM_CHUNK_FRAMES * (uint64_t)stream->file_info.channels * sizeof(int16_t));
+
+	pthread_mutex_lock(&stream_mutex);
+	streams[slot] = stream;
+	pthread_mutex_unlock(&stream_mutex);
+
+	return stream;
+}
+
+static void sound_stream_rewind(sound_stream_t *stream) {
+	alSourceStop(stream->source);
+	alSourcei(stream->source, AL_BUFFER, 0);
+	sf_seek(stream->file, 0, SEEK_SET);
+}
+
+sound_source_t sound_stream_prepare(sound_stream_t *stream) {
+	uint8_t buffers_filled = 0;
+
+	pthread_mutex_lock(&stream_mutex);
+	sound_stream_rewind(stream);
+	while(buffers_filled < SOUND_STREAM_BUFFER_COUNT && sound_stream_fill(stream, stream->buffers[buffers_filled])) {
+		buffers_filled++;
+	}
+
+	alSourceQueueBuffers(stream->source, buffers_filled, stream->buffers);
+	stream->playing = 1;
+	pthread_mutex_unlock(&stream_mutex);
+
+	return stream->source;
+}
+
+void sound_stream_stop(sound_stream_t *stream) {
+	pthread_mutex_lock(&stream_mutex);
+	stream->playing = 0;
+	sound_stream_rewind(stream);
+	pthread_mutex_unlock(&stream_mutex);
+}
+
+void sound_stream_close(sound_stream_t *stream) {
+	pthread_mutex_lock(&stream_mutex);
+	for(uint8_t i = 0; i < SOUND_STREAM_COUNT_MAX; i++) {
+		if(streams[i] == stream) {
+			streams[i] = NULL;
+		}
+	}
+
+	stream->playing = 0;
+	sound_stream_rewind(stream);
+	pthread_mutex_unlock(&stream_mutex);
+
+	memstat_release(MEMSTAT_AUDIO, stream->buffers[0]);
+	alDeleteBuffers(SOUND_STREAM_BUFFER_COUNT, stream->buffers);
+	sf_close(stream->file);
+	free(stream->encoded);
+	free(stream->chunk);
+	free(stream);
+}
@@ -0,0 +1,248 @@
+#include "sound_thread.h"
+#include "sound_pool.h"
+#include "sound_stream.h"
+#include "sound_latency.h"
+#include "timer.h"
+#include "trace.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <AL/al.h>
+#include <AL/alext.h>
+
+#include "callstat.h"
+
+/* How often sound_thread_wait checks whether the thread caught up */
+#define SOUND_THREAD_WAIT_NS			200000
+
+static sound_thread_command_t queue[SOUND_THREAD_QUEUE_SIZE];
+static uint32_t queue_head = 0; /* only written by the main thread */
+static uint32_t queue_tail = 0; /* only written by the audio thread */
+static uint32_t executed_count = 0;
+static uint32_t pushed_count = 0;
+
+/* Popped but not due yet, in time order. Audio thread only */
+static sound_thread_command_t pending[SOUND_THREAD_PENDING_MAX];
+static uint32_t pending_count = 0;
+
+static pthread_t thread;
+static uint8_t thread_running = 0;
+
+/* lets "sound_thread_wait" cut the thread's sleep short instead of waiting out SOUND_THREAD_SLEEP_NS */
+static pthread_mutex_t wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond;
+static uint8_t wake_requested = 0;
+
+static LPALDEFERUPDATESSOFT al_defer_updates = NULL;
+static LPALPROCESSUPDATESSOFT al_process_updates = NULL;
+
+void sound_thread_push(const sound_thread_command_t command) {
+	const struct timespec wait_time = {0, SOUND_THREAD_WAIT_NS};
+	const uint32_t head = queue_head;
+
+	/* full, which only happens if the thread's stuck */
+	while(head - __atomic_load_n(&queue_tail, __ATOMIC_ACQUIRE) >= SOUND_THREAD_QUEUE_SIZE) {
+		nanosleep(&wait_time, NULL);
+	}
+
+	queue[head & (SOUND_THREAD_QUEUE_SIZE - 1)] = command;
+	__atomic_store_n(&queue_head, head + 1, __ATOMIC_RELEASE);
+	pushed_count++;
+}
+
+static void sound_thread_wake(void) {
+	pthread_mutex_lock(&wake_mutex);
+	wake_requested = 1;
+	pthread_cond_signal(&wake_cond);
+	pthread_mutex_unlock(&wake_mutex);
+}
+
+void sound_thread_wait(void) {
+	const struct timespec wait_time = {0, SOUND_THREAD_WAIT_NS};
+
+	if(__atomic_load_n(&executed_count, __ATOMIC_ACQUIRE) == pushed_count)
+		return;
+
+	sound_thread_wake();
+	while(__atomic_load_n(&executed_count, __ATOMIC_ACQUIRE) != pushed_count) {
+		nanosleep(&wait_time, NULL);
+	}
+}
+
+/* Keeps "pending" sorted by time, and in push order for equal times */
+static void sound_thread_pending_insert(const sound_thread_command_t command) {
+	uint32_t index = pending_count;
+
+	while(index > 0 && pending[index - 1].time > command.time) {
+		pending[index] = pending[index - 1];
+		index--;
+	}
+
+	pending[index] = command;
+	pending_count++;
+}
+
+static void sound_thread_drain(void) {
+	const uint32_t head = __atomic_load_n(&queue_head, __ATOMIC_ACQUIRE);
+	uint32_t tail = queue_tail;
+
+	while(tail != head && pending_count < SOUND_THREAD_PENDING_MAX) {
+		sound_thread_pending_insert(queue[tail & (SOUND_THREAD_QUEUE_SIZE - 1)]);
+		tail++;
+	}
+
+	__atomic_store_n(&queue_tail, tail, __ATOMIC_RELEASE);
+}
+
+/* Returns the source to start, if there's one */
+static sound_source_t sound_thread_execute(const sound_thread_command_t *command) {
+	const sound_t sound = command->sound;
+	sound_source_t source = 0;
+
+	switch(command->type) {
+		case SOUND_THREAD_PLAY:
+			if(sound.stream) {
+				source = sound_stream_prepare(sound.stream);
+			} else if(!sound.source) {
+				source = sound_pool_acquire(sound, command->gain);
+			} else {
+				alSourceRewind(sound.source);
+				source = sound.source;
+			}
+			sound_latency_trigger(sound, source, command->requested);
+			break;
+
+		case SOUND_THREAD_STOP:
+			if(sound.stream) {
+				sound_stream_stop(sound.stream);
+			} else if(!sound.source) {
+				sound_pool_stop(sound);
+			} else {
+				alSourceStop(sound.source);
+			}
+			break;
+
+		case SOUND_THREAD_GAIN:
+			if(!sound.source) {
+				sound_pool_set_gain(sound, command->gain);
+			} else {
+				alSourcef(sound.source, AL_GAIN, command->gain);
+			}
+			break;
+
+		case SOUND_THREAD_RELEASE:
+			if(sound.stream) {
+				sound_stream_stop(sound.stream);
+			} else if(!sound.source) {
+				sound_pool_release(sound);
+			} else {
+				alSourceStop(sound.source);
+			}
+			break;
+	}
+
+	return source;
+}
+
+/* Runs everything that's due, a batch of equal times at a time. Returns when the next thing is due, or 0 */
+static uint64_t sound_thread_run_due(const uint64_t now) {
+	sound_source_t starts[SOUND_THREAD_PENDING_MAX];
+	uint32_t done = 0;
+
+	while(done < pending_count && pending[done].time <= now) {
+		const uint64_t batch_time = pending[done].time;
+		const uint64_t batch_start = timer_now_ns();
+		uint32_t start_count = 0;
+
+		if(al_defer_updates) {
+			al_defer_updates();
+		}
+
+		for(; done < pending_count && pending[done].time == batch_time; done++) {
+			const sound_source_t source = sound_thread_execute(&pending[done]);
+			if(source) {
+				starts[start_count++] = source;
+			}
+		}
+
+		if(start_count) {
+			alSourcePlayv((int32_t)start_count, starts);
+		}
+
+		if(al_process_updates) {
+			al_process_updates();
+		}
+		trace_complete("batch", "audio", batch_start, timer_now_ns());
+	}
+
+	if(done) {
+		pending_count -= done;
+		memmove(pending, pending + done, pending_count * sizeof(sound_thread_command_t));
+		__atomic_add_fetch(&executed_count, done, __ATOMIC_RELEASE);
+	}
+
+	return pending_count ? pending[0].time : 0;
+}
+
+static void *sound_thread_main(void *arg) {
+	(void)arg;
+	trace_thread_name("audio");
+
+	while(__atomic_load_n(&thread_running, __ATOMIC_ACQUIRE)) {
+		uint64_t now, next, wake;
+		struct timespec wake_time;
+
+		sound_thread_drain();
+		now = timer_now_ns();
+		next = sound_thread_run_due(now);
+		sound_stream_service_all();
+		sound_latency_poll();
+
+		/* sleep until the next command is due, but never longer than a stream can go without a refill */
+		wake = now + SOUND_THREAD_SLEEP_NS;
+		if(next && next < wake) {
+			wake = next;
+		}
+		wake_time.tv_sec = (time_t)(wake / 1000000000);
+		wake_time.tv_nsec = (long)(wake % 1000000000);
+
+		pthread_mutex_lock(&wake_mutex);
+		while(!wake_requested) {
+			if(pthread_cond_timedwait(&wake_cond, &wake_mutex, &wake_time) == ETIMEDOUT)
+				break;
+		}
+		wake_requested = 0;
+		pthread_mutex_unlock(&wake_mutex);
+	}
+
+	return NULL;
+}
+
+void sound_thread_create(void) {
+	if(alIsExtensionPresent("AL_SOFT_deferred_updates")) {
+		al_defer_updates = (LPALDEFERUPDATESSOFT)alGetProcAddress("alDeferUpdatesSOFT");
+		al_process_updates = (LPALPROCESSUPDATESSOFT)alGetProcAddress("alProcessUpdatesSOFT");
+	}
+
+	{ /* the sleep deadlines come from the same monotonic clock as everything else */
+		pthread_condattr_t attributes;
+		pthread_condattr_init(&attributes);
+		pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+		pthread_cond_init(&wake_cond, &attributes);
+		pthread_condattr_destroy(&attributes);
+	}
+
+	__atomic_store_n(&thread_running, 1, __ATOMIC_RELEASE);
+	pthread_create(&thread, NULL, sound_thread_main, NULL);
+}
+
+void sound_thread_destroy(void) {
+	sound_thread_wait();
+	__atomic_store_n(&thread_running, 0, __ATOMIC_RELEASE);
+	sound_thread_wake();
+	pthread_join(thread, NULL);
+	pthread_cond_destroy(&wake_cond);
+}
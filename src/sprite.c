@@ -1,16 +1,16 @@
 #include "sprite.h"
 #include "texture.h"
+#include "memstat.h"
 
 #include <glad/glad.h>
-#include <stdarg.h>
+#include <stdio.h>
 #include <assert.h>
 
-sprite_t sprite_create(vec2 pos, vec2 size, const char *path_format, const uint16_t texture_count) {
+#include "callstat.h"
+#include "heapstat.h"
+
+sprite_t sprite_create_empty(vec2 pos, vec2 size, const uint16_t texture_count) {
 	sprite_t sprite;
-	char *paths;
-	uint8_t texture_path_length = 0;
-	uint8_t chars_excluded = 0;
-	const char *c = path_format;
 	const float vertices[] = {
 		0.0f,	0.0f,	0.0f, 0.0f,
 		1.0f,	0.0f,	1.0f, 0.0f,
@@ -39,28 +39,29 @@ sprite_t sprite_create(vec2 pos, vec2 size, const char *path_format, const uint1
 
 	sprite.textures = calloc(texture_count, sizeof(texture_t));
 	sprite.texture_count = texture_count;
-	while(*c) {
-		if(*c == '%') {
-			chars_excluded++;
-			continue;
-		} c++;
-	}
+	glm_vec2_copy(pos, sprite.position);
 
-	texture_path_length = (uint8_t)(c - path_format - chars_excluded);
+	return sprite;
+}
+
+void sprite_texture_path(const char *path_format, const uint16_t texture_count, const uint16_t texture_index, char *output) {
 	if(texture_count - 1) {
-		paths = calloc(texture_count * (texture_path_length + 6), sizeof(char));
-		for(uint16_t i = 0; i < texture_count; i++) {
-			const uint32_t offset = (i * texture_path_length);
-			sprintf(paths + offset, "%s%u.png", path_format, i);
-			sprite.textures[i] = texture_create(paths + offset, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
-		}
+		snprintf(output, SPRITE_PATH_LENGTH_MAX, "%s%u.png", path_format, texture_index);
 	} else {
-		paths = calloc(texture_count * texture_path_length, sizeof(char));
-		sprintf(paths, "%s", path_format);
-		*sprite.textures = texture_create(paths, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+		snprintf(output, SPRITE_PATH_LENGTH_MAX, "%s", path_format);
+	}
+}
+
+sprite_t sprite_create(vec2 pos, vec2 size, const char *path_format, const uint16_t texture_count) {
+	sprite_t sprite;
+	char path[SPRITE_PATH_LENGTH_MAX];
+
+	sprite = sprite_create_empty(pos, size, texture_count);
+	memstat_owner_set(path_format);
+	for(uint16_t i = 0; i < texture_count; i++) {
+		sprite_texture_path(path_format, texture_count, i, path);
+		sprite.textures[i] = texture_create(path, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
 	}
-	free(paths);
-	glm_vec2_copy(pos, sprite.position);
 
 	return sprite;
 }
@@ -88,8 +89,15 @@ void sprite_draw(sprite_t sprite, uint32_t shader, const uint16_t texture_index)
 }
 
 void sprite_destroy(sprite_t *sprite) {
-	for(uint8_t i = 0; i < sprite->texture_count; i++) {
-		glDeleteTextures(1, &sprite->textures[i]);
+	for(uint16_t i = 0; i < sprite->texture_count; i++) {
+		texture_destroy(&sprite->textures[i]);
 	}
 	free(sprite->textures);
+	sprite->textures = NULL;
+	sprite->texture_count = 0;
+
+	glDeleteBuffers(1, &sprite->vbo);
+	glDeleteVertexArrays(1, &sprite->vao);
+	sprite->vbo = 0;
+	sprite->vao = 0;
 }
@@ -0,0 +1,125 @@
+#include "startup.h"
+#include "timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+	const char *name;
+	uint64_t duration;
+} startup_phase_t;
+
+typedef struct {
+	char path[STARTUP_PATH_LENGTH_MAX];
+	const char *kind;
+	uint64_t decode;
+	uint64_t upload;
+} startup_asset_t;
+
+static startup_phase_t phases[STARTUP_PHASE_MAX];
+static startup_asset_t assets[STARTUP_ASSET_MAX];
+static uint8_t phase_count = 0;
+static uint16_t asset_count = 0;
+static uint32_t asset_dropped = 0;
+static uint64_t startup_start = 0;
+static uint64_t phase_start = 0;
+static uint8_t startup_done = 0;
+
+void startup_begin(void) {
+	startup_start = timer_now_ns();
+	phase_start = startup_start;
+}
+
+void startup_phase(const char *name) {
+	const uint64_t now = timer_now_ns();
+	if(startup_done)
+		return;
+
+	if(phase_count < STARTUP_PHASE_MAX) {
+		phases[phase_count].name = name;
+		phases[phase_count].duration = now - phase_start;
+		phase_count++;
+	}
+	phase_start = now;
+}
+
+void startup_asset(const char *path, const char *kind, const uint64_t decode_ns, const uint64_t upload_ns) {
+	if(startup_done)
+		return;
+
+	if(asset_count >= STARTUP_ASSET_MAX) {
+		asset_dropped++;
+		return;
+	}
+
+	snprintf(assets[asset_count].path, STARTUP_PATH_LENGTH_MAX, "%s", path);
+	assets[asset_count].kind = kind;
+	assets[asset_count].decode = decode_ns;
+	assets[asset_count].upload = upload_ns;
+	asset_count++;
+}
+
+/* Slowest first */
+static int startup_asset_compare(const void *a, const void *b) {
+	const startup_asset_t *x = a;
+	const startup_asset_t *y = b;
+	const uint64_t x_total = x->decode + x->upload;
+	const uint64_t y_total = y->decode + y->upload;
+	return (x_total < y_total) - (x_total > y_total);
+}
+
+static void startup_print(const uint64_t total, const uint64_t decode_total, const uint64_t upload_total) {
+	const uint16_t slowest_count = (asset_count < STARTUP_SLOWEST_COUNT) ? asset_count : STARTUP_SLOWEST_COUNT;
+
+	printf("STARTUP in %.2f ms\n", timer_ms(total));
+	for(uint8_t i = 0; i < phase_count; i++) {
+		printf("    %-24s %9.2f ms %5.1f%%\n", phases[i].name, timer_ms(phases[i].duration), (100.0 * (double)phases[i].duration) / (double)total);
+	}
+
+	printf("    %u files, %.2f ms decoding (spread over the workers) and %.2f ms handing off\n", asset_count + asset_dropped, timer_ms(decode_total), timer_ms(upload_total));
+	printf("    %-48s %-8s %9s %9s\n", "SLOWEST FILES", "KIND", "DECODE", "UPLOAD");
+	for(uint16_t i = 0; i < slowest_count; i++) {
+		printf("    %-48s %-8s %9.2f %9.2f\n", assets[i].path, assets[i].kind, timer_ms(assets[i].decode), timer_ms(assets[i].upload));
+	}
+}
+
+static void startup_write_json(const char *path, const uint64_t total) {
+	FILE *file = fopen(path, "w");
+	if(!file) {
+		printf("ERROR: Couldn't open '%s' to write the startup report to.\n", path);
+		return;
+	}
+
+	fprintf(file, "{\n\t\"total_ms\": %.3f,\n\t\"phases\": [", timer_ms(total));
+	for(uint8_t i = 0; i < phase_count; i++) {
+		fprintf(file, "%s\n\t\t{\"name\": \"%s\", \"ms\": %.3f}", i ? "," : "", phases[i].name, timer_ms(phases[i].duration));
+	}
+
+	/* already sorted, so the slowest are simply the first few */
+	fprintf(file, "\n\t],\n\t\"assets\": [");
+	for(uint16_t i = 0; i < asset_count; i++) {
+		fprintf(file, "%s\n\t\t{\"path\": \"%s\", \"kind\": \"%s\", \"decode_ms\": %.3f, \"upload_ms\": %.3f}", i ? "," : "",
+			assets[i].path, assets[i].kind, timer_ms(assets[i].decode), timer_ms(assets[i].upload));
+	}
+	fprintf(file, "\n\t]\n}\n");
+	fclose(file);
+}
+
+void startup_finish(const char *json_path) {
+	uint64_t total, decode_total = 0, upload_total = 0;
+	if(startup_done)
+		return;
+
+	startup_done = 1;
+	total = timer_now_ns() - startup_start;
+	for(uint16_t i = 0; i < asset_count; i++) {
+		decode_total += assets[i].decode;
+		upload_total += assets[i].upload;
+	}
+	qsort(assets, asset_count, sizeof(startup_asset_t), startup_asset_compare);
+
+	startup_print(total, decode_total, upload_total);
+	if(json_path) {
+		startup_write_json(json_path, total);
+	}
+}
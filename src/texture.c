@@ -1,12 +1,39 @@
 #include "texture.h"
+#include "memstat.h"
+#include "upload.h"
+#include "cache.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <glad/glad.h>
 
-texture_t texture_create(const char *path, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation) {
-	int32_t texture_width, texture_height, texture_format;
-	uint8_t *texture_data;
+#include "callstat.h"
+
+texture_image_t texture_image_load(const char *path) {
+	/* stb_image leaves the size alone when it fails */
+	texture_image_t image = {NULL, 0, 0, 0};
+
+	stbi_set_flip_vertically_on_load_thread(1);
+	image.pixels = stbi_load(path, &image.width, &image.height, &image.channels, 0);
+	#ifdef DEBUG
+		if(!image.pixels) {
+			printf("ERROR: Texture at: %s fucked up.\n", path);
+		}
+	#endif
+
+	return image;
+}
+
+uint64_t texture_image_size(const texture_image_t image) {
+	return (uint64_t)image.width * (uint64_t)image.height * (uint64_t)image.channels;
+}
+
+void texture_image_free(texture_image_t *image) {
+	stbi_image_free(image->pixels);
+	image->pixels = NULL;
+}
+
+texture_t texture_create_from_image(const texture_image_t image, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation) {
 	uint32_t texture;
 	int32_t texture_format_enums[5] = {
 		0,
@@ -16,6 +43,10 @@ texture_t texture_create(const char *path, const int32_t wrap_mode, const int32_
 		GL_RGBA
 	};
 
+	/* a file that didn't load gets no texture rather than one sized from nothing */
+	if(!image.pixels)
+		return 0;
+
 	glGenTextures(1, &texture);
 	glBindTexture(GL_TEXTURE_2D, texture);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_mode);
@@ -23,19 +54,59 @@ texture_t texture_create(const char *path, const int32_t wrap_mode, const int32_
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_interpolation);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_interpolation);
 
-	stbi_set_flip_vertically_on_load(1);
-	texture_data = stbi_load(path, &texture_width, &texture_height, &texture_format, 0);
-	#ifdef DEBUG
-		if(!texture_data) {
-			printf("ERROR: Texture at: %s fucked up.\n", path);
-			return 255;
-		}
-	#endif
-
-	glTexImage2D(GL_TEXTURE_2D, 0, texture_format_enums[texture_format], texture_width, texture_height, 0, (uint32_t)texture_format_enums[texture_format], GL_UNSIGNED_BYTE, texture_data);
-	stbi_image_free(texture_data);
+	upload_texture_image(image, texture_format_enums[image.channels], (uint32_t)texture_format_enums[image.channels]);
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
 	return texture;
 }
+
+static void texture_delete(uint32_t texture) {
+	memstat_release(MEMSTAT_TEXTURE, texture);
+	glDeleteTextures(1, &texture);
+}
+
+static uint64_t texture_variant(const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation) {
+	return ((uint64_t)(uint32_t)wrap_mode << 32) | ((uint64_t)(uint32_t)min_interpolation << 16) | (uint64_t)(uint32_t)mag_interpolation;
+}
+
+texture_t texture_find(const char *path, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation) {
+	return cache_acquire(CACHE_TEXTURE, path, texture_variant(wrap_mode, min_interpolation, mag_interpolation));
+}
+
+texture_t texture_create_shared(const char *path, const texture_image_t image, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation) {
+	texture_t texture;
+
+	texture = texture_create_from_image(image, wrap_mode, min_interpolation, mag_interpolation);
+	if(image.pixels) {
+		memstat_record(MEMSTAT_TEXTURE, memstat_group_get(), memstat_owner_get(), texture, texture_image_size(image));
+		cache_insert(CACHE_TEXTURE, path, texture_variant(wrap_mode, min_interpolation, mag_interpolation), texture, texture_image_size(image), texture_delete);
+	}
+
+	return texture;
+}
+
+texture_t texture_create(const char *path, const int32_t wrap_mode, const int32_t min_interpolation, const int32_t mag_interpolation) {
+	texture_image_t image;
+	texture_t texture;
+
+	texture = texture_find(path, wrap_mode, min_interpolation, mag_interpolation);
+	if(texture)
+		return texture;
+
+	image = texture_image_load(path);
+	texture = texture_create_shared(path, image, wrap_mode, min_interpolation, mag_interpolation);
+	texture_image_free(&image);
+
+	return texture;
+}
+
+void texture_destroy(texture_t *texture) {
+	if(!*texture)
+		return;
+
+	if(!cache_release(CACHE_TEXTURE, *texture)) {
+		texture_delete(*texture);
+	}
+	*texture = 0;
+}
@@ -0,0 +1,13 @@
+#include "timer.h"
+
+#include <time.h>
+
+uint64_t timer_now_ns(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+double timer_ms(const uint64_t ns) {
+	return (double)ns / 1e6;
+}
@@ -0,0 +1,139 @@
+#include "trace.h"
+#include "timer.h"
+
+#include <stdio.h>
+#include <pthread.h>
+
+static FILE *trace_file = NULL;
+static uint64_t trace_start = 0;
+static uint64_t trace_frame_start = 0;
+static uint32_t trace_frame_count = 0;
+static uint8_t trace_first_event = 1;
+static uint32_t trace_thread_count = 0;
+static __thread uint32_t trace_thread_id = 0;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t trace_thread_get(void) {
+	if(!trace_thread_id) {
+		trace_thread_id = __atomic_add_fetch(&trace_thread_count, 1, __ATOMIC_RELAXED);
+	}
+
+	return trace_thread_id;
+}
+
+/* Only quotes, backslashes and control characters need escaping in JSON */
+static void trace_write_string(const char *string) {
+	fputc('"', trace_file);
+	for(const char *c = string; *c; c++) {
+		if(*c == '"' || *c == '\\') {
+			fputc('\\', trace_file);
+			fputc(*c, trace_file);
+		} else if((unsigned char)*c < 0x20) {
+			fprintf(trace_file, "\\u%04x", (unsigned char)*c);
+		} else {
+			fputc(*c, trace_file);
+		}
+	}
+	fputc('"', trace_file);
+}
+
+/* Writes everything up to "ts", the caller adds whatever else the phase needs and the closing brace. Takes the lock */
+static void trace_event_open(const char *name, const char *category, const char phase, const uint64_t time) {
+	pthread_mutex_lock(&trace_mutex);
+	fputs(trace_first_event ? "\n" : ",\n", trace_file);
+	trace_first_event = 0;
+
+	fputs("{\"name\":", trace_file);
+	trace_write_string(name);
+	fputs(",\"cat\":", trace_file);
+	trace_write_string(category);
+	fprintf(trace_file, ",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", phase, trace_thread_get(), (double)(time - trace_start) / 1000.0);
+}
+
+static void trace_event_close(void) {
+	fputc('}', trace_file);
+	pthread_mutex_unlock(&trace_mutex);
+}
+
+uint8_t trace_create(const char *path) {
+	trace_file = fopen(path, "w");
+	if(!trace_file) {
+		printf("ERROR: Couldn't open '%s' to write the trace to.\n", path);
+		return 0;
+	}
+
+	trace_start = timer_now_ns();
+	trace_frame_start = trace_start;
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", trace_file);
+	return 1;
+}
+
+void trace_destroy(void) {
+	if(!trace_file)
+		return;
+
+	fputs("\n]}\n", trace_file);
+	fclose(trace_file);
+	trace_file = NULL;
+}
+
+uint8_t trace_active(void) {
+	return trace_file != NULL;
+}
+
+void trace_thread_name(const char *name) {
+	if(!trace_file)
+		return;
+
+	trace_event_open("thread_name", "__metadata", 'M', trace_start);
+	fputs(",\"args\":{\"name\":", trace_file);
+	trace_write_string(name);
+	fputc('}', trace_file);
+	trace_event_close();
+}
+
+void trace_begin(const char *name, const char *category) {
+	if(!trace_file)
+		return;
+
+	trace_event_open(name, category, 'B', timer_now_ns());
+	trace_event_close();
+}
+
+void trace_end(const char *name, const char *category) {
+	if(!trace_file)
+		return;
+
+	trace_event_open(name, category, 'E', timer_now_ns());
+	trace_event_close();
+}
+
+void trace_complete(const char *name, const char *category, const uint64_t start, const uint64_t end) {
+	if(!trace_file)
+		return;
+
+	trace_event_open(name, category, 'X', start);
+	fprintf(trace_file, ",\"dur\":%.3f", (double)(end - start) / 1000.0);
+	trace_event_close();
+}
+
+void trace_instant(const char *name, const char *category) {
+	if(!trace_file)
+		return;
+
+	trace_event_open(name, category, 'i', timer_now_ns());
+	fputs(",\"s\":\"g\"", trace_file);
+	trace_event_close();
+}
+
+void trace_frame(void) {
+	uint64_t now;
+	if(!trace_file)
+		return;
+
+	now = timer_now_ns();
+	trace_event_open("frame", "frame", 'X', trace_frame_start);
+	fprintf(trace_file, ",\"dur\":%.3f,\"args\":{\"frame\":%u}", (double)(now - trace_frame_start) / 1000.0, trace_frame_count++);
+	trace_event_close();
+	trace_frame_start = now;
+}
@@ -0,0 +1,95 @@
+#include "upload.h"
+
+#include <glad/glad.h>
+#include <string.h>
+
+#include "callstat.h"
+
+#define UPLOAD_FENCE_TIMEOUT	1000000000
+
+typedef struct {
+	uint32_t buffer;
+	uint64_t size;
+	GLsync fence;
+} upload_slot_t;
+
+static upload_slot_t upload_slots[UPLOAD_RING_SIZE];
+static uint8_t upload_slot_next = 0;
+static uint8_t upload_system_loaded = 0;
+
+void upload_system_create(void) {
+	for(uint8_t i = 0; i < UPLOAD_RING_SIZE; i++) {
+		glGenBuffers(1, &upload_slots[i].buffer);
+		upload_slots[i].size = 0;
+		upload_slots[i].fence = NULL;
+	}
+
+	upload_slot_next = 0;
+	upload_system_loaded = 1;
+}
+
+void upload_system_destroy(void) {
+	if(!upload_system_loaded)
+		return;
+
+	for(uint8_t i = 0; i < UPLOAD_RING_SIZE; i++) {
+		if(upload_slots[i].fence) {
+			glDeleteSync(upload_slots[i].fence);
+		}
+		glDeleteBuffers(1, &upload_slots[i].buffer);
+	}
+
+	upload_system_loaded = 0;
+}
+
+static void upload_slot_wait(upload_slot_t *slot) {
+	if(!slot->fence)
+		return;
+
+	while(glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, UPLOAD_FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED);
+	glDeleteSync(slot->fence);
+	slot->fence = NULL;
+}
+
+void upload_texture_image(const texture_image_t image, const int32_t internal_format, const uint32_t format) {
+	const uint64_t size = texture_image_size(image);
+	upload_slot_t *slot;
+	void *mapped;
+
+	if(!image.pixels)
+		return;
+
+	/* stb_image hands us tightly packed rows */
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if(!upload_system_loaded) {
+		glTexImage2D(GL_TEXTURE_2D, 0, internal_format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+		return;
+	}
+
+	slot = &upload_slots[upload_slot_next];
+	upload_slot_next = (upload_slot_next + 1) % UPLOAD_RING_SIZE;
+	upload_slot_wait(slot);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->buffer);
+	if(size > slot->size) {
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+		slot->size = size;
+	}
+
+	/* the fence already told us the GPU is done with this one */
+	mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if(!mapped) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexImage2D(GL_TEXTURE_2D, 0, internal_format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+		return;
+	}
+
+	memcpy(mapped, image.pixels, size);
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, internal_format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, NULL);
+	slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}